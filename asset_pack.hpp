@@ -0,0 +1,205 @@
+#ifndef ASSET_PACK_HPP
+#define ASSET_PACK_HPP
+
+// =================================================================
+// ASSET PACK
+// A single-file archive of the assets folder, memory-mapped at startup so
+// SFML can decode straight out of the mapping with loadFromMemory.
+//
+// Layout (little-endian):
+//   PackHeader
+//   PackEntry[entryCount]     sorted by name, looked up by binary search
+//   blobs                     each starting on a PACK_ALIGNMENT boundary
+// Entry names are the paths the game opens, e.g. "assets/dungeon.png".
+// =================================================================
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace PackFormat {
+    const char MAGIC[4] = {'D', 'E', 'P', 'K'};
+    const std::uint32_t VERSION = 1;
+    const std::uint64_t PACK_ALIGNMENT = 64;
+    const size_t MAX_NAME_LENGTH = 111;
+
+    struct PackHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t entryCount;
+        std::uint32_t reserved;
+    };
+
+    struct PackEntry {
+        char name[MAX_NAME_LENGTH + 1];
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    inline std::uint64_t alignUp(std::uint64_t value) {
+        return (value + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+    }
+}
+
+// Read-only memory mapping of a whole file.
+class MappedFile {
+private:
+    const unsigned char* data = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int fd = -1;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { close(); return false; }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mapping) { close(); return false; }
+        data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!data) { close(); return false; }
+        length = static_cast<size_t>(size.QuadPart);
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) { close(); return false; }
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) { close(); return false; }
+        data = static_cast<const unsigned char*>(view);
+        length = static_cast<size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data) munmap(const_cast<unsigned char*>(data), length);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        data = nullptr;
+        length = 0;
+    }
+
+    const unsigned char* getData() const { return data; }
+    size_t size() const { return length; }
+};
+
+// The mapped pack. Mapped once before any loader thread starts and read-only
+// afterwards, so lookups are safe from any thread. Every accessor falls back
+// gracefully when no pack is open or an asset is missing from it.
+class AssetPack {
+private:
+    static MappedFile file;
+    static const PackFormat::PackEntry* entries;
+    static std::uint32_t entryCount;
+
+public:
+    struct Blob {
+        const void* data;
+        size_t size;
+    };
+
+    static bool open(const std::string& path) {
+        using namespace PackFormat;
+        entries = nullptr;
+        entryCount = 0;
+        if (!file.open(path)) return false;
+
+        const PackHeader* header = reinterpret_cast<const PackHeader*>(file.getData());
+        bool valid = file.size() >= sizeof(PackHeader)
+            && std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0
+            && header->version == VERSION
+            && sizeof(PackHeader) + static_cast<std::uint64_t>(header->entryCount) * sizeof(PackEntry) <= file.size();
+        if (!valid) { file.close(); return false; }
+
+        // Each blob must lie inside the file (checked without overflow), each
+        // name must be terminated within its field, and names must strictly
+        // increase, since find() binary-searches them with strcmp.
+        const PackEntry* table = reinterpret_cast<const PackEntry*>(file.getData() + sizeof(PackHeader));
+        const std::uint64_t fileSize = file.size();
+        for (std::uint32_t i = 0; i < header->entryCount; ++i) {
+            const PackEntry& entry = table[i];
+            bool entryValid = entry.offset <= fileSize && entry.size <= fileSize - entry.offset
+                && std::memchr(entry.name, '\0', sizeof(entry.name)) != nullptr
+                && (i == 0 || std::strcmp(table[i - 1].name, entry.name) < 0);
+            if (!entryValid) { file.close(); return false; }
+        }
+        entries = table;
+        entryCount = header->entryCount;
+        return true;
+    }
+
+    static bool isOpen() { return entries != nullptr; }
+
+    static bool find(const std::string& path, Blob& blob) {
+        if (!entries) return false;
+        const PackFormat::PackEntry* end = entries + entryCount;
+        const PackFormat::PackEntry* it = std::lower_bound(entries, end, path,
+            [](const PackFormat::PackEntry& entry, const std::string& name) { return std::strcmp(entry.name, name.c_str()) < 0; });
+        if (it == end || path != it->name) return false;
+        blob.data = file.getData() + it->offset;
+        blob.size = static_cast<size_t>(it->size);
+        return true;
+    }
+
+    // Size of an asset, from the pack when packed, otherwise from disk; -1 if missing.
+    static long long assetSize(const std::string& path) {
+        Blob blob;
+        if (find(path, blob)) return static_cast<long long>(blob.size);
+        std::ifstream loose(path, std::ios::binary | std::ios::ate);
+        return loose ? static_cast<long long>(loose.tellg()) : -1;
+    }
+
+    // Loads an sf::Font/sf::Texture/sf::Image from the pack, or from disk if it is not packed.
+    template <typename Resource>
+    static bool load(Resource& resource, const std::string& path) {
+        Blob blob;
+        if (find(path, blob)) return resource.loadFromMemory(blob.data, blob.size);
+        return resource.loadFromFile(path);
+    }
+
+    // Same as load() for streamed sources such as sf::Music.
+    template <typename Stream>
+    static bool openStream(Stream& stream, const std::string& path) {
+        Blob blob;
+        if (find(path, blob)) return stream.openFromMemory(blob.data, blob.size);
+        return stream.openFromFile(path);
+    }
+};
+
+#endif // ASSET_PACK_HPP
@@ -0,0 +1,240 @@
+#ifndef AUDIO_HPP
+#define AUDIO_HPP
+
+// =================================================================
+// AUDIO ENGINE
+// Sound effects and music behind one lock-free command queue.
+//   audio.play(SoundId::HIT);
+//   audio.playMusic(MusicId::DUNGEON, 1.5f);
+// Every effect is decoded into an sf::SoundBuffer and every music track
+// opened by start(), from the asset pack when packed, so triggering a
+// sound loads and allocates nothing: play() writes a small command into a
+// fixed ring that the audio thread drains every few milliseconds. Effects
+// play on a fixed pool of voices; when all are busy, the oldest voice of
+// the lowest priority is stolen, unless the new sound ranks below it.
+// Music tracks crossfade on the same thread. Missing files are reported
+// once at start() and are silent afterwards.
+// The queue is single-producer: call play()/playMusic() from the main
+// thread only.
+// =================================================================
+
+#include <SFML/Audio.hpp>
+#include "asset_pack.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+enum class SoundId : std::uint8_t { STEP, HIT, PICKUP, CONFIRM, TYPE, VICTORY, DEFEAT, COUNT };
+enum class MusicId : std::uint8_t { NONE, DUNGEON, COUNT };
+
+// Fixed-capacity single-producer/single-consumer ring. One slot is kept
+// free to tell full from empty, so it holds Capacity - 1 items.
+template <typename T, size_t Capacity>
+class SpscQueue {
+private:
+    T slots[Capacity];
+    std::atomic<size_t> head{0}; // Next slot to read; written by the consumer.
+    std::atomic<size_t> tail{0}; // Next slot to write; written by the producer.
+public:
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1) % Capacity;
+        if (next == head.load(std::memory_order_acquire)) return false;
+        slots[t] = item;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+    bool pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = slots[h];
+        head.store((h + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+};
+
+class AudioEngine {
+public:
+    static const size_t MAX_VOICES = 16;
+    static const size_t QUEUE_CAPACITY = 256;
+
+private:
+    struct SoundDef {
+        const char* path;
+        int priority; // Higher survives voice stealing.
+        float volume;
+    };
+    static const SoundDef& soundDef(SoundId id) {
+        static const SoundDef defs[static_cast<size_t>(SoundId::COUNT)] = {
+            {"assets/sfx_step.ogg", 0, 60.f},
+            {"assets/sfx_hit.ogg", 2, 100.f},
+            {"assets/sfx_pickup.ogg", 2, 90.f},
+            {"assets/sfx_confirm.ogg", 1, 80.f},
+            {"assets/sfx_type.ogg", 0, 50.f},
+            {"assets/sfx_victory.ogg", 3, 100.f},
+            {"assets/sfx_defeat.ogg", 3, 100.f},
+        };
+        return defs[static_cast<size_t>(id)];
+    }
+    static const char* musicPath(MusicId id) {
+        switch (id) {
+            case MusicId::DUNGEON: return "assets/dungeon_music.ogg";
+            default: return nullptr;
+        }
+    }
+
+    struct Command {
+        enum Type : std::uint8_t { PLAY_SOUND, PLAY_MUSIC } type;
+        std::uint8_t id;
+        float value; // Pitch for sounds, fade seconds for music.
+    };
+
+    struct Voice {
+        sf::Sound sound;
+        int priority = 0;
+        std::uint64_t startedAt = 0;
+    };
+
+    struct Track {
+        sf::Music music;
+        bool loaded = false;
+        float volume = 0.f; // Current fade level, 0..1.
+        float target = 0.f;
+        float rate = 0.f;   // Fade change per second.
+    };
+
+    sf::SoundBuffer buffers[static_cast<size_t>(SoundId::COUNT)];
+    bool bufferLoaded[static_cast<size_t>(SoundId::COUNT)] = {};
+    Voice voices[MAX_VOICES];
+    Track tracks[static_cast<size_t>(MusicId::COUNT)];
+    MusicId currentMusic = MusicId::NONE; // Audio thread only.
+    float musicVolume = 50.f;
+    std::uint64_t playCount = 0;
+
+    SpscQueue<Command, QUEUE_CAPACITY> queue;
+    std::atomic<bool> running{false};
+    std::atomic<unsigned long> dropped{0};
+    std::thread worker;
+
+    Voice* pickVoice(int priority) {
+        Voice* victim = nullptr;
+        for (Voice& voice : voices) {
+            if (voice.sound.getStatus() == sf::SoundSource::Stopped) return &voice;
+            if (!victim || voice.priority < victim->priority
+                || (voice.priority == victim->priority && voice.startedAt < victim->startedAt)) victim = &voice;
+        }
+        return victim->priority <= priority ? victim : nullptr;
+    }
+
+    void playSound(SoundId id, float pitch) {
+        size_t index = static_cast<size_t>(id);
+        if (!bufferLoaded[index]) return;
+        const SoundDef& def = soundDef(id);
+        Voice* voice = pickVoice(def.priority);
+        if (!voice) return;
+        voice->sound.stop();
+        voice->sound.setBuffer(buffers[index]);
+        voice->sound.setVolume(def.volume);
+        voice->sound.setPitch(pitch);
+        voice->priority = def.priority;
+        voice->startedAt = ++playCount;
+        voice->sound.play();
+    }
+
+    void switchMusic(MusicId id, float fadeSeconds) {
+        if (id == currentMusic) return;
+        float rate = fadeSeconds > 0.f ? 1.f / fadeSeconds : 0.f;
+        if (currentMusic != MusicId::NONE) {
+            Track& old = tracks[static_cast<size_t>(currentMusic)];
+            old.target = 0.f;
+            old.rate = rate;
+        }
+        currentMusic = id;
+        Track& track = tracks[static_cast<size_t>(id)];
+        if (id == MusicId::NONE || !track.loaded) return;
+        track.target = 1.f;
+        track.rate = rate;
+        if (track.music.getStatus() != sf::SoundSource::Playing) {
+            track.volume = rate > 0.f ? 0.f : 1.f;
+            track.music.setVolume(track.volume * musicVolume);
+            track.music.play();
+        }
+    }
+
+    void updateFades(float dt) {
+        for (Track& track : tracks) {
+            if (!track.loaded || track.volume == track.target) continue;
+            float step = track.rate > 0.f ? track.rate * dt : 1.f;
+            track.volume = track.volume < track.target ? std::min(track.target, track.volume + step) : std::max(track.target, track.volume - step);
+            track.music.setVolume(track.volume * musicVolume);
+            if (track.volume == 0.f) track.music.stop();
+        }
+    }
+
+    void audioLoop() {
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point last = Clock::now();
+        while (running.load(std::memory_order_acquire)) {
+            Command command;
+            while (queue.pop(command)) {
+                if (command.type == Command::PLAY_SOUND) playSound(static_cast<SoundId>(command.id), command.value);
+                else switchMusic(static_cast<MusicId>(command.id), command.value);
+            }
+            Clock::time_point now = Clock::now();
+            updateFades(std::chrono::duration<float>(now - last).count());
+            last = now;
+            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+        }
+    }
+
+    void push(Command command) {
+        if (!running.load(std::memory_order_relaxed) || !queue.push(command)) dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+public:
+    AudioEngine() = default;
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+    ~AudioEngine() { stop(); }
+
+    // Loads every effect and opens every track, then starts the audio thread.
+    void start(float musicVolumePercent) {
+        if (running.load()) return;
+        musicVolume = musicVolumePercent;
+        for (size_t i = 0; i < static_cast<size_t>(SoundId::COUNT); ++i) {
+            const char* path = soundDef(static_cast<SoundId>(i)).path;
+            bufferLoaded[i] = AssetPack::assetSize(path) >= 0 && AssetPack::load(buffers[i], path);
+            if (!bufferLoaded[i]) std::cerr << "Sound effect unavailable: " << path << std::endl;
+        }
+        for (size_t i = 0; i < static_cast<size_t>(MusicId::COUNT); ++i) {
+            const char* path = musicPath(static_cast<MusicId>(i));
+            if (!path) continue;
+            Track& track = tracks[i];
+            track.loaded = AssetPack::openStream(track.music, path);
+            if (!track.loaded) std::cerr << "Music unavailable: " << path << std::endl;
+            track.music.setLoop(true);
+        }
+        running.store(true, std::memory_order_release);
+        worker = std::thread(&AudioEngine::audioLoop, this);
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        worker.join();
+        for (Voice& voice : voices) voice.sound.stop();
+        for (Track& track : tracks) track.music.stop();
+    }
+
+    void play(SoundId id, float pitch = 1.f) { push({Command::PLAY_SOUND, static_cast<std::uint8_t>(id), pitch}); }
+    // Crossfades from the current track; MusicId::NONE fades out.
+    void playMusic(MusicId id, float fadeSeconds) { push({Command::PLAY_MUSIC, static_cast<std::uint8_t>(id), fadeSeconds}); }
+
+    // Commands lost to a full queue (or sent before start()).
+    unsigned long droppedCommands() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+#endif // AUDIO_HPP
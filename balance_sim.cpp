@@ -0,0 +1,296 @@
+#include "core.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cerrno>
+#include <limits>
+
+// =================================================================
+// BALANCE SIMULATOR
+// Monte Carlo playthroughs of the core rules on all cores.
+//   balance_sim [--runs N] [--threads T] [--seed S] [--chunk C]
+//               [--strategy random|direct|potion] [--generated MINIONS]
+//               [--health H] [--moves M] [--damage NAME=VALUE]...
+//               [--undo-depth D]
+// Results depend only on the seed and --chunk, never on the thread count
+// or scheduling: runs are cut into chunks at multiples of --chunk, and
+// every chunk reseeds its worker's engine from (seed, chunk index).
+// =================================================================
+
+namespace {
+    const int MAX_STEPS = 1000;
+    const int OUTCOME_COUNT = static_cast<int>(Outcome::QUIT) + 1;
+    const int MAX_TRACKED_HEALTH = 100;
+    const int MAX_TRACKED_MOVES = 256;
+    const unsigned int MAX_THREADS = 1024;
+
+    enum class Strategy { RANDOM, DIRECT, POTION };
+
+    struct DamageOverride {
+        std::string enemyName;
+        int damage;
+    };
+
+    struct Options {
+        std::int64_t runs = 1000000;
+        unsigned int threads = 0;
+        unsigned int seed = 12345;
+        std::int64_t chunk = 1024;
+        Strategy strategy = Strategy::RANDOM;
+        int generatedMinions = -1; // -1 plays the fixed setupDungeon layout.
+        int health = 100;
+        int moves = 10;
+        size_t undoDepth = 0; // 0 lets players backtrack all the way.
+        std::vector<DamageOverride> damageOverrides;
+        bool help = false;
+    };
+
+    // Per-worker totals. Each worker writes only its own copy, so the hot
+    // loop needs no atomics; the copies are summed once all workers join.
+    struct alignas(64) Stats {
+        std::int64_t runs = 0;
+        std::int64_t steps = 0;
+        std::int64_t outcomes[OUTCOME_COUNT] = {};
+        std::int64_t finalHealth[MAX_TRACKED_HEALTH + 1] = {};
+        std::int64_t movesUsed[MAX_TRACKED_MOVES + 1] = {};
+
+        void merge(const Stats& other) {
+            runs += other.runs;
+            steps += other.steps;
+            for (int i = 0; i < OUTCOME_COUNT; ++i) outcomes[i] += other.outcomes[i];
+            for (int i = 0; i <= MAX_TRACKED_HEALTH; ++i) finalHealth[i] += other.finalHealth[i];
+            for (int i = 0; i <= MAX_TRACKED_MOVES; ++i) movesUsed[i] += other.movesUsed[i];
+        }
+    };
+
+    // A worker's share of the chunk indices. Owners and thieves both claim
+    // chunks with fetch_add, so stealing needs no locks.
+    struct alignas(64) WorkRange {
+        std::atomic<std::int64_t> next{0};
+        std::int64_t end = 0;
+
+        bool claim(std::int64_t& chunk) {
+            if (next.load(std::memory_order_relaxed) >= end) return false;
+            chunk = next.fetch_add(1, std::memory_order_relaxed);
+            return chunk < end;
+        }
+    };
+
+    Action chooseAction(const GameSession& session, Strategy strategy, std::mt19937& rng) {
+        if (strategy == Strategy::RANDOM) {
+            Action legal[sizeof(ALL_ACTIONS) / sizeof(ALL_ACTIONS[0])];
+            int count = 0;
+            for (Action action : ALL_ACTIONS) {
+                if (session.canApply(action)) legal[count++] = action;
+            }
+            if (count == 0) return Action::QUIT;
+            std::uniform_int_distribution<int> pick(0, count - 1);
+            return legal[pick(rng)];
+        }
+
+        switch (session.getState()) {
+            case InteractionState::COMBAT: return Action::FIGHT;
+            case InteractionState::CHOICE: return strategy == Strategy::POTION ? Action::CHOOSE_POTION : Action::CHOOSE_KEY;
+            case InteractionState::MESSAGE: return Action::CONTINUE;
+            case InteractionState::EXPLORING: break;
+        }
+        return session.canApply(Action::COLLECT) ? Action::COLLECT : Action::FORWARD;
+    }
+
+    void applyOverrides(Dungeon& dungeon, const std::vector<DamageOverride>& overrides) {
+        if (overrides.empty()) return;
+        for (RoomId id = 0; id < dungeon.roomCount(); ++id) {
+            Enemy* enemy = entityCast<Enemy>(dungeon.getRoom(id).entity);
+            if (!enemy) continue;
+            for (const DamageOverride& o : overrides) {
+                if (enemy->getName() == o.enemyName) enemy->setDamage(o.damage);
+            }
+        }
+    }
+
+    // Plays chunk `chunk`: runs [chunk * options.chunk, ...) up to options.runs.
+    void playChunk(const Options& options, std::int64_t chunk, std::mt19937& rng, Stats& stats) {
+        std::uint64_t index = static_cast<std::uint64_t>(chunk);
+        std::seed_seq seq{options.seed, static_cast<unsigned int>(index), static_cast<unsigned int>(index >> 32)};
+        rng.seed(seq);
+        std::int64_t begin = chunk * options.chunk;
+        std::int64_t end = std::min(begin + options.chunk, options.runs);
+
+        for (std::int64_t run = begin; run < end; ++run) {
+            GameSession session("Simulated", options.health, options.moves);
+            if (options.generatedMinions >= 0) generateDungeon(session.getDungeon(), rng, options.generatedMinions);
+            else setupDungeon(session.getDungeon());
+            session.getDungeon().setUndoDepth(options.undoDepth);
+            applyOverrides(session.getDungeon(), options.damageOverrides);
+            session.start();
+
+            int step = 0;
+            while (step < MAX_STEPS && !session.isOver()) {
+                session.apply(chooseAction(session, options.strategy, rng));
+                ++step;
+            }
+
+            const Player& player = session.getPlayer();
+            stats.runs++;
+            stats.steps += step;
+            stats.outcomes[static_cast<int>(session.getOutcome())]++;
+            stats.finalHealth[std::max(0, std::min(player.getHealth(), MAX_TRACKED_HEALTH))]++;
+            stats.movesUsed[std::max(0, std::min(options.moves - player.getMoves(), MAX_TRACKED_MOVES))]++;
+        }
+    }
+
+    void worker(const Options& options, unsigned int index, std::vector<WorkRange>& ranges, Stats& stats) {
+        std::mt19937 rng;
+        std::int64_t chunk;
+        // Drain our own range first, then steal from the others in turn.
+        for (size_t offset = 0; offset < ranges.size(); ++offset) {
+            WorkRange& range = ranges[(index + offset) % ranges.size()];
+            while (range.claim(chunk)) playChunk(options, chunk, rng, stats);
+        }
+    }
+
+    int percentile(const std::int64_t* histogram, int size, std::int64_t total, double p) {
+        std::int64_t target = static_cast<std::int64_t>(p * total);
+        std::int64_t seen = 0;
+        for (int i = 0; i < size; ++i) {
+            seen += histogram[i];
+            if (seen > target) return i;
+        }
+        return size - 1;
+    }
+
+    void printDistribution(const char* label, const std::int64_t* histogram, int size, std::int64_t total) {
+        std::cout << label << ": p10 " << percentile(histogram, size, total, 0.10)
+                  << ", p50 " << percentile(histogram, size, total, 0.50)
+                  << ", p90 " << percentile(histogram, size, total, 0.90) << std::endl;
+    }
+
+    void printReport(const Options& options, const Stats& total, double seconds) {
+        std::cout << total.runs << " playthroughs on " << options.threads << " threads in "
+                  << std::fixed << std::setprecision(3) << seconds << " s";
+        if (seconds > 0) std::cout << " (" << static_cast<std::int64_t>(total.runs / seconds) << " / s)";
+        std::cout << std::endl;
+        if (total.runs == 0) return;
+
+        double winRate = 100.0 * total.outcomes[static_cast<int>(Outcome::VICTORY)] / total.runs;
+        std::cout << "Win rate: " << std::setprecision(2) << winRate << "%" << std::endl;
+        std::cout << "Outcomes:" << std::endl;
+        for (int i = 0; i < OUTCOME_COUNT; ++i) {
+            if (total.outcomes[i] == 0) continue;
+            Outcome outcome = static_cast<Outcome>(i);
+            double share = 100.0 * total.outcomes[i] / total.runs;
+            std::cout << "  " << std::setw(6) << share << "%  " << std::setw(10) << total.outcomes[i] << "  "
+                      << (outcome == Outcome::NONE ? "Unfinished" : outcomeReason(outcome)) << std::endl;
+        }
+        printDistribution("Final health", total.finalHealth, MAX_TRACKED_HEALTH + 1, total.runs);
+        printDistribution("Moves used", total.movesUsed, MAX_TRACKED_MOVES + 1, total.runs);
+        std::cout << "Average actions per run: " << std::setprecision(2) << static_cast<double>(total.steps) / total.runs << std::endl;
+    }
+
+    const char* const USAGE =
+        "Usage: balance_sim [--runs N] [--threads T] [--seed S] [--chunk C]\n"
+        "                   [--strategy random|direct|potion] [--generated MINIONS]\n"
+        "                   [--health H] [--moves M] [--damage NAME=VALUE]...\n"
+        "                   [--undo-depth D]\n";
+
+    bool usageError(const std::string& problem) {
+        std::cerr << problem << "\n" << USAGE;
+        return false;
+    }
+
+    // Whole-string unsigned decimal no larger than `max`; rejects empty
+    // strings, signs and trailing text.
+    bool parseCount(const char* text, std::uint64_t max, std::uint64_t& value) {
+        if (!text || *text < '0' || *text > '9') return false;
+        char* end = nullptr;
+        errno = 0;
+        unsigned long long parsed = std::strtoull(text, &end, 10);
+        if (*end != '\0' || errno == ERANGE || parsed > max) return false;
+        value = parsed;
+        return true;
+    }
+
+    template <typename T>
+    bool parseValue(const std::string& option, const char* text, T minimum, T& out, T maximum = std::numeric_limits<T>::max()) {
+        std::uint64_t value = 0;
+        if (!parseCount(text, static_cast<std::uint64_t>(maximum), value) || value < static_cast<std::uint64_t>(minimum)) {
+            return usageError(option + " needs a whole number from " + std::to_string(minimum) + " to "
+                              + std::to_string(maximum) + ", got: " + text);
+        }
+        out = static_cast<T>(value);
+        return true;
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            bool ok = true;
+            if (arg == "--help" || arg == "-h") options.help = true;
+            else if (arg == "--runs" && hasValue) ok = parseValue<std::int64_t>(arg, argv[++i], 1, options.runs);
+            else if (arg == "--threads" && hasValue) ok = parseValue(arg, argv[++i], 1u, options.threads, MAX_THREADS);
+            else if (arg == "--seed" && hasValue) ok = parseValue(arg, argv[++i], 0u, options.seed);
+            else if (arg == "--chunk" && hasValue) ok = parseValue<std::int64_t>(arg, argv[++i], 1, options.chunk);
+            else if (arg == "--generated" && hasValue) ok = parseValue(arg, argv[++i], 0, options.generatedMinions);
+            else if (arg == "--health" && hasValue) ok = parseValue(arg, argv[++i], 1, options.health);
+            else if (arg == "--moves" && hasValue) ok = parseValue(arg, argv[++i], 0, options.moves);
+            else if (arg == "--undo-depth" && hasValue) ok = parseValue<size_t>(arg, argv[++i], 0, options.undoDepth);
+            else if (arg == "--strategy" && hasValue) {
+                std::string name = argv[++i];
+                if (name == "random") options.strategy = Strategy::RANDOM;
+                else if (name == "direct") options.strategy = Strategy::DIRECT;
+                else if (name == "potion") options.strategy = Strategy::POTION;
+                else return usageError("Unknown strategy: " + name);
+            }
+            else if (arg == "--damage" && hasValue) {
+                std::string spec = argv[++i];
+                size_t eq = spec.find('=');
+                if (eq == std::string::npos || eq == 0) return usageError("Expected NAME=VALUE, got: " + spec);
+                DamageOverride override{spec.substr(0, eq), 0};
+                if (!parseValue(arg, spec.c_str() + eq + 1, 0, override.damage)) return false;
+                options.damageOverrides.push_back(override);
+            }
+            else return usageError("Unknown or incomplete option: " + arg);
+            if (!ok) return false;
+        }
+        if (options.threads == 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+    if (options.help) { std::cout << USAGE; return 0; }
+
+    // Chunks, not runs, are dealt out, so chunk boundaries (and with them
+    // the seeds) are the same whatever the thread count.
+    std::vector<WorkRange> ranges(options.threads);
+    std::int64_t chunks = (std::max<std::int64_t>(0, options.runs) + options.chunk - 1) / options.chunk;
+    std::int64_t share = chunks / options.threads;
+    for (unsigned int i = 0; i < options.threads; ++i) {
+        ranges[i].next.store(i * share);
+        ranges[i].end = (i + 1 == options.threads) ? chunks : (i + 1) * share;
+    }
+    std::vector<Stats> perThread(options.threads);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < options.threads; ++i) {
+        threads.emplace_back(worker, std::cref(options), i, std::ref(ranges), std::ref(perThread[i]));
+    }
+    for (std::thread& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Stats total;
+    for (const Stats& stats : perThread) total.merge(stats);
+    printReport(options, total, seconds);
+    return 0;
+}
@@ -0,0 +1,268 @@
+// =================================================================
+// HOT-PATH BENCHMARKS
+//   bench [--filter NAME] [--reps N] [--warmup N] [--min-ms MS]
+//         [--csv FILE] [--json FILE]
+// Microbenchmarks of what the game runs every step or frame, on fixed
+// inputs and seeds so runs on two commits compare directly (see
+// bench.hpp for the harness). The game's own classes come from main.cpp,
+// compiled here with DUNGEON_NO_MAIN; nothing opens a window. Run from
+// the repository root so assets/ is found.
+// =================================================================
+
+#define DUNGEON_NO_MAIN
+#include "main.cpp"
+#include "bench.hpp"
+
+namespace {
+    const char* const WINNING_ROUTE = "FFFFFFFCF1FFFFF"; // headless --search's shortest win.
+    const int LARGE_DUNGEON_MINIONS = 100000;
+
+    const std::string DESCRIPTION =
+        "The air is thick with the smell of damp stone and old smoke. Water drips from the vaulted "
+        "ceiling into shallow pools, and somewhere beyond the flickering torchlight something large "
+        "shifts its weight, scraping claws across the flagstones as it waits for you to step closer.";
+
+    // GamePlayScreen::updateUI without a Game or a window: the screen's
+    // own HudText refresh, plus resolving the room's background.
+    struct HudPass {
+        HudText text;
+
+        void attach(GameSession& session) {
+            text.reset();
+            session.onLog = [this](LogLine line, const std::string& arg) { text.addAction(logTemplate(line), arg); };
+        }
+
+        void refresh(GameSession& session) {
+            FrameArena::reset();
+            if (text.refresh(session) & Dirty::ROOM) {
+                Dungeon& dungeon = session.getDungeon();
+                Bench::keep(backgroundOf(dungeon, *dungeon.getCurrentRoom()).index);
+            }
+        }
+    };
+
+    // One scripted win from a fresh session, refreshing `hud` after every
+    // action when given.
+    Outcome playRoute(HudPass* hud) {
+        GameSession session("Bench", 100, 10);
+        setupDungeon(session.getDungeon());
+        if (hud) hud->attach(session);
+        session.start();
+        if (hud) hud->refresh(session);
+        for (const char* key = WINNING_ROUTE; *key && !session.isOver(); ++key) {
+            Action action;
+            if (actionForKey(session.getState(), *key, action)) session.apply(action);
+            if (hud) hud->refresh(session);
+        }
+        return session.getOutcome();
+    }
+
+    void benchText(Bench& bench) {
+        sf::Text text;
+        text.setFont(ResourceManager::getFont(GameConfig::FONT_PATH_ARIBLK));
+        text.setCharacterSize(28);
+        const float width = GameConfig::WINDOW_WIDTH - 60.f;
+
+        bench.run("text.wrap_text", [&](size_t ops) {
+            for (size_t i = 0; i < ops; ++i) {
+                text.setString(DESCRIPTION);
+                Utils::wrapText(text, width);
+            }
+            Bench::keep(text.getString().getSize());
+        });
+        bench.run("text.layout_cached", [&](size_t ops) {
+            for (size_t i = 0; i < ops; ++i) TextLayout::setWrappedString(text, DESCRIPTION, width);
+            Bench::keep(text.getString().getSize());
+        });
+        // A fresh width every call misses the layout cache every time.
+        bench.run("text.layout_uncached", [&](size_t ops) {
+            for (size_t i = 0; i < ops; ++i) TextLayout::setWrappedString(text, DESCRIPTION, width - static_cast<float>(i % 4096) / 16.f);
+            Bench::keep(text.getString().getSize());
+        });
+    }
+
+    void benchInventory(Bench& bench) {
+        std::vector<ItemId> items;
+        for (int i = 0; i < 32; ++i) items.push_back(ItemRegistry::intern("Bench Item " + std::to_string(i)));
+
+        Inventory<ItemId> inventory;
+        bench.run("inventory.add", [&](size_t ops) {
+            for (size_t i = 0; i < ops; ++i) {
+                if ((i & 15) == 0) inventory.clear();
+                inventory.add(items[i & 15]);
+            }
+            Bench::keep(inventory.size());
+        });
+
+        inventory.clear();
+        for (size_t i = 0; i < 16; ++i) inventory.add(items[i * 2]);
+        bench.run("inventory.has", [&](size_t ops) {
+            size_t found = 0;
+            for (size_t i = 0; i < ops; ++i) found += inventory.has(items[i & 31]);
+            Bench::keep(found);
+        });
+
+        // Six items, the most a real playthrough holds.
+        bench.run("inventory.sorted_string", [&](size_t ops) {
+            size_t length = 0;
+            for (size_t i = 0; i < ops; ++i) {
+                inventory.clear();
+                for (size_t k = 0; k < 6; ++k) inventory.add(items[(i + k * 5) & 31]);
+                length += inventory.getSortedString().size();
+            }
+            Bench::keep(length);
+        });
+        bench.run("inventory.sorted_string_cached", [&](size_t ops) {
+            size_t length = 0;
+            for (size_t i = 0; i < ops; ++i) length += inventory.getSortedString().size();
+            Bench::keep(length);
+        });
+    }
+
+    void benchStack(Bench& bench) {
+        Stack<RoomId> stack;
+        // One operation is a push and a pop, in runs of 256.
+        bench.run("stack.push_pop", [&](size_t ops) {
+            for (size_t i = 0; i < ops; ++i) {
+                stack.push(static_cast<RoomId>(i));
+                if ((i & 255) == 255) while (!stack.isEmpty()) stack.pop();
+            }
+            while (!stack.isEmpty()) stack.pop();
+            Bench::keep(stack.size());
+        });
+        Stack<RoomId> ring(64);
+        bench.run("stack.push_ring", [&](size_t ops) {
+            for (size_t i = 0; i < ops; ++i) ring.push(static_cast<RoomId>(i));
+            Bench::keep(ring.top());
+        });
+    }
+
+    void benchDungeon(Bench& bench) {
+        // One operation per room.
+        bench.run("dungeon.add_room", [&](size_t ops) {
+            Player player("Bench", 100, 10);
+            Dungeon dungeon(player);
+            StringId name = dungeon.intern("Corridor"), description = dungeon.intern(DESCRIPTION), background = dungeon.intern("dungeon.png");
+            for (size_t i = 0; i < ops; ++i) dungeon.addRoom(name, description, background);
+            Bench::keep(dungeon.exitCount(0));
+        });
+        bench.run("dungeon.generate", [&](size_t ops) {
+            Player player("Bench", 100, 10);
+            Dungeon dungeon(player);
+            std::mt19937 rng(12345);
+            generateDungeon(dungeon, rng, static_cast<int>(ops));
+            Bench::keep(dungeon.roomCount());
+        });
+
+        Player player("Bench", 100, 10);
+        Dungeon dungeon(player);
+        std::mt19937 rng(12345);
+        generateDungeon(dungeon, rng, LARGE_DUNGEON_MINIONS);
+        const std::vector<RoomId> noPath;
+        bench.run("dungeon.move_forward", [&](size_t ops) {
+            for (size_t i = 0; i < ops; ++i) {
+                if (!dungeon.canMoveForward()) dungeon.restorePosition(0, noPath);
+                dungeon.moveForward();
+            }
+            Bench::keep(dungeon.getCurrentRoomId());
+        });
+        dungeon.restorePosition(0, noPath);
+        bench.run("dungeon.move_forward_back", [&](size_t ops) {
+            for (size_t i = 0; i < ops; ++i) {
+                dungeon.moveForward();
+                dungeon.moveBack();
+            }
+            Bench::keep(dungeon.getCurrentRoomId());
+        });
+    }
+
+    void benchResources(Bench& bench) {
+        const std::string names[] = {"dungeon.png", "wizard.png", "dragon.png", "zombie.png", "sword.png",
+                                     "potion.png", "monster.png", "finalboss.png", "finaldoor.png"};
+        bench.run("resources.find_texture", [&](size_t ops) {
+            int sum = 0;
+            for (size_t i = 0; i < ops; ++i) sum += ResourceManager::findTextureHandle(names[i % 9]).index;
+            Bench::keep(sum);
+        });
+
+        // Resident textures only: three pinned backgrounds fit the budget.
+        std::vector<TextureHandle> handles;
+        for (size_t i = 0; i < 3; ++i) handles.push_back(ResourceManager::getTextureHandle(names[i]));
+        ResourceManager::retainTextures(handles);
+        bench.run("resources.get_texture", [&](size_t ops) {
+            unsigned int width = 0;
+            for (size_t i = 0; i < ops; ++i) width += ResourceManager::get(handles[i % 3]).getSize().x;
+            Bench::keep(width);
+        });
+    }
+
+    void benchTweens(Bench& bench) {
+        TweenSystem tweens;
+        std::vector<float> values(64);
+        for (size_t i = 0; i < values.size(); ++i) tweens.start({0.f, 1.f, 1.f, Ease::IN_OUT_QUAD, true, &values[i]});
+        sf::Time now;
+        // One operation is a fixed step with 64 looping tweens.
+        bench.run("tweens.update_64", [&](size_t ops) {
+            for (size_t i = 0; i < ops; ++i) {
+                now += sf::microseconds(8333);
+                tweens.update(now);
+            }
+            Bench::keep(values[0] * 1000.f);
+        });
+    }
+
+    void benchGameplay(Bench& bench) {
+        // The difference between these two is the HUD's share of a playthrough.
+        bench.run("session.playthrough", [&](size_t ops) {
+            int wins = 0;
+            for (size_t i = 0; i < ops; ++i) wins += playRoute(nullptr) == Outcome::VICTORY;
+            Bench::keep(wins);
+        });
+        HudPass hud;
+        bench.run("gameplay.update_ui_playthrough", [&](size_t ops) {
+            int wins = 0;
+            for (size_t i = 0; i < ops; ++i) wins += playRoute(&hud) == Outcome::VICTORY;
+            Bench::keep(wins);
+        });
+
+        char buffer[ActionLog::MAX_LINE_LENGTH + 1];
+        bench.run("log.format_line", [&](size_t ops) {
+            size_t length = 0;
+            for (size_t i = 0; i < ops; ++i) length += formatLogLine(logTemplate(LogLine::ITEM_RESULT), DESCRIPTION, buffer, sizeof(buffer));
+            Bench::keep(length);
+        });
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Bench::Options options;
+    std::string csvPath, jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) { std::cerr << "Missing value for " << arg << std::endl; return 1; }
+        std::string value = argv[++i];
+        if (arg == "--filter") options.filter = value;
+        else if (arg == "--reps") options.repetitions = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--warmup") options.warmup = std::max(0, std::atoi(value.c_str()));
+        else if (arg == "--min-ms") options.minBatchMs = std::atof(value.c_str());
+        else if (arg == "--csv") csvPath = value;
+        else if (arg == "--json") jsonPath = value;
+        else { std::cerr << "Unknown option: " << arg << std::endl; return 1; }
+    }
+
+    Bench bench(options);
+    benchText(bench);
+    benchInventory(bench);
+    benchStack(bench);
+    benchDungeon(bench);
+    benchResources(bench);
+    benchTweens(bench);
+    benchGameplay(bench);
+
+    std::cout << "(sink " << Bench::sinkValue() << ")" << std::endl;
+    bool written = true;
+    if (!csvPath.empty()) written = bench.writeCsv(csvPath) && written;
+    if (!jsonPath.empty()) written = bench.writeJson(jsonPath) && written;
+    if (!written) std::cerr << "Could not write the results." << std::endl;
+    return written ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+// =================================================================
+// MICROBENCHMARK HARNESS
+//   Bench bench(options);
+//   bench.run("stack.push_pop", [&](size_t ops) { ... ops operations ... });
+// A body performs `ops` operations and hands what it computed to
+// Bench::keep() so the optimiser cannot drop the work. The harness sizes
+// a batch so one takes at least minBatchMs, runs warmup batches, then
+// times `repetitions` batches and reports nanoseconds per operation:
+// min, p50, p90, p99 and mean over the batches. The medians are what to
+// compare between commits; the spread shows how noisy the machine was.
+// Results print as a table and are kept for writeCsv()/writeJson().
+// =================================================================
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <algorithm>
+
+class Bench {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Options {
+        int warmup = 3;
+        int repetitions = 30;
+        double minBatchMs = 5.0;
+        std::string filter; // Substring of the names to run; empty runs all.
+    };
+
+    struct Result {
+        std::string name;
+        size_t opsPerBatch;
+        int batches;
+        double minNs, p50Ns, p90Ns, p99Ns, meanNs;
+    };
+
+private:
+    Options options;
+    std::vector<Result> results;
+    static std::uint64_t& sink() { static std::uint64_t value = 0; return value; }
+
+    template <typename Body>
+    static double timeBatch(Body& body, size_t ops) {
+        Clock::time_point start = Clock::now();
+        body(ops);
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    static double percentile(const std::vector<double>& sorted, double p) {
+        size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+public:
+    explicit Bench(const Options& benchOptions) : options(benchOptions) {
+        std::printf("%-32s %10s %10s %10s %10s %10s %10s\n", "benchmark (ns/op)", "ops/batch", "min", "p50", "p90", "p99", "mean");
+    }
+
+    // Folds a value into a sink the compiler has to assume is read.
+    template <typename T>
+    static void keep(const T& value) { sink() += static_cast<std::uint64_t>(value); }
+    static void keep(const std::string& value) { sink() += value.size(); }
+    static std::uint64_t sinkValue() { return sink(); }
+
+    template <typename Body>
+    void run(const char* name, Body body) {
+        if (!options.filter.empty() && std::string(name).find(options.filter) == std::string::npos) return;
+
+        // Double the batch until it is long enough to time reliably.
+        size_t ops = 1;
+        const double minBatchNs = options.minBatchMs * 1e6;
+        while (timeBatch(body, ops) < minBatchNs && ops < (size_t(1) << 30)) ops *= 2;
+
+        for (int i = 0; i < options.warmup; ++i) timeBatch(body, ops);
+        std::vector<double> perOp;
+        perOp.reserve(options.repetitions);
+        for (int i = 0; i < options.repetitions; ++i) perOp.push_back(timeBatch(body, ops) / ops);
+        std::sort(perOp.begin(), perOp.end());
+
+        double sum = 0.0;
+        for (double ns : perOp) sum += ns;
+        Result result = {name, ops, options.repetitions, perOp.front(), percentile(perOp, 0.50),
+                         percentile(perOp, 0.90), percentile(perOp, 0.99), sum / perOp.size()};
+        results.push_back(result);
+        std::printf("%-32s %10zu %10.1f %10.1f %10.1f %10.1f %10.1f\n", name, ops,
+                    result.minNs, result.p50Ns, result.p90Ns, result.p99Ns, result.meanNs);
+        std::fflush(stdout);
+    }
+
+    const std::vector<Result>& getResults() const { return results; }
+
+    bool writeCsv(const std::string& path) const {
+        std::ofstream out(path);
+        out << "name,ops_per_batch,batches,min_ns,p50_ns,p90_ns,p99_ns,mean_ns\n";
+        for (const Result& r : results) {
+            out << r.name << ',' << r.opsPerBatch << ',' << r.batches << ',' << r.minNs << ',' << r.p50Ns << ','
+                << r.p90Ns << ',' << r.p99Ns << ',' << r.meanNs << '\n';
+        }
+        return out.good();
+    }
+
+    bool writeJson(const std::string& path) const {
+        std::ofstream out(path);
+        out << "{\"unit\":\"ns_per_op\",\"benchmarks\":[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << (i == 0 ? "" : ",\n") << "{\"name\":\"" << r.name << "\",\"ops_per_batch\":" << r.opsPerBatch
+                << ",\"batches\":" << r.batches << ",\"min\":" << r.minNs << ",\"p50\":" << r.p50Ns
+                << ",\"p90\":" << r.p90Ns << ",\"p99\":" << r.p99Ns << ",\"mean\":" << r.meanNs << '}';
+        }
+        out << "\n]}\n";
+        return out.good();
+    }
+};
+
+#endif // BENCH_HPP
@@ -0,0 +1,727 @@
+#include "core.hpp"
+#include <mutex>
+#include <atomic>
+#include <cstring>
+
+// =================================================================
+// 1. GAME LOGIC 
+// =================================================================
+
+namespace {
+    // Names are append-only and published through `count`, so lookups of
+    // registered names scan without the lock; only adding takes it.
+    struct ItemRegistryState {
+        std::mutex mutex;
+        std::string names[ItemRegistry::MAX_ITEMS];
+        std::atomic<std::uint16_t> count{0};
+
+        bool lookup(const std::string& name, ItemId& id) const {
+            std::uint16_t published = count.load(std::memory_order_acquire);
+            for (std::uint16_t i = 0; i < published; ++i) {
+                if (names[i] == name) { id = ItemId{i}; return true; }
+            }
+            return false;
+        }
+
+        // Caller holds the mutex.
+        ItemId add(const std::string& name) {
+            std::uint16_t next = count.load(std::memory_order_relaxed);
+            if (next == ItemRegistry::MAX_ITEMS) throw std::runtime_error("Too many item kinds: " + name);
+            names[next] = name;
+            count.store(next + 1, std::memory_order_release);
+            return ItemId{next};
+        }
+
+        // Registered in the order of the ids in Items.
+        ItemRegistryState() {
+            add("Sword");
+            add("Golden Key");
+        }
+    };
+
+    ItemRegistryState& itemRegistry() {
+        static ItemRegistryState state;
+        return state;
+    }
+}
+
+ItemId ItemRegistry::intern(const std::string& name) {
+    ItemRegistryState& registry = itemRegistry();
+    ItemId id;
+    if (registry.lookup(name, id)) return id;
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.lookup(name, id) ? id : registry.add(name);
+}
+
+bool ItemRegistry::find(const std::string& name, ItemId& id) { return itemRegistry().lookup(name, id); }
+
+bool ItemRegistry::internAll(const std::vector<std::string>& names) {
+    ItemRegistryState& registry = itemRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<const std::string*> missing;
+    ItemId id;
+    for (const std::string& name : names) {
+        bool seen = registry.lookup(name, id) || std::any_of(missing.begin(), missing.end(), [&](const std::string* m) { return *m == name; });
+        if (!seen) missing.push_back(&name);
+    }
+    if (registry.count.load(std::memory_order_relaxed) + missing.size() > MAX_ITEMS) return false;
+    for (const std::string* name : missing) registry.add(*name);
+    return true;
+}
+
+// An id only exists once its name has been stored, so no lock is needed.
+const std::string& ItemRegistry::name(ItemId id) { return itemRegistry().names[id.value]; }
+
+void Item::interact(Player& player, std::string& interactionResult) {
+    player.collectItem(itemId);
+    interactionResult = "You picked up the " + this->getName() + ".";
+}
+
+void Potion::interact(Player& player, std::string& interactionResult) {
+    player.heal(100);
+    interactionResult = "You drank the potion and feel fully restored!";
+}
+
+void Enemy::interact(Player& player, std::string& interactionResult) {
+    interactionResult = "";
+}
+
+void BossEnemy::interact(Player& player, std::string& interactionResult) {
+    interactionResult = "";
+}
+
+// =================================================================
+// 1b. GAME SESSION (Rules & Action API)
+// =================================================================
+
+const char* outcomeReason(Outcome outcome) {
+    switch (outcome) {
+        case Outcome::VICTORY: return "You used the Golden key and escaped. You are VICTORIOUS!";
+        case Outcome::DIED_IN_COMBAT: return "You have died in combat.";
+        case Outcome::OUT_OF_MOVES: return "You have run out of moves.";
+        case Outcome::FLED: return "You fled in terror!";
+        case Outcome::DOOR_LOCKED_NO_KEY: return "The final door is locked. You needed the Golden Key.";
+        case Outcome::DOOR_LOCKED_BOSS_ALIVE: return "The final door is locked tight. The boss must be defeated!";
+        case Outcome::QUIT: return "You left the dungeon.";
+        case Outcome::NONE: break;
+    }
+    return "";
+}
+
+const char* logTemplate(LogLine line) {
+    switch (line) {
+        case LogLine::ADVENTURE_BEGINS: return "Your adventure begins...";
+        case LogLine::ENTERED_ROOM: return "Entered The %";
+        case LogLine::COLLECTED_SWORD: return "You collected the Sword.";
+        case LogLine::ITEM_RESULT: return "%";
+        case LogLine::FLED: return "Fled in terror!";
+        case LogLine::FOUGHT: return "Fought the %";
+        case LogLine::SLAIN_BY: return "You were slain by the %";
+        case LogLine::DEFEATED: return "Defeated the %";
+        case LogLine::BOSS_DEFEATED: return "The final boss is defeated!";
+        case LogLine::TOOK_KEY: return "You took the Golden Key.";
+        case LogLine::DRANK_POTION: return "You drank the Health Potion.";
+    }
+    return "";
+}
+
+size_t formatLogLine(const char* format, const std::string& arg, char* out, size_t capacity) {
+    if (capacity == 0) return 0;
+    size_t length = 0;
+    for (const char* c = format; *c && length + 1 < capacity; ++c) {
+        if (*c != '%') { out[length++] = *c; continue; }
+        size_t copy = std::min(arg.size(), capacity - 1 - length);
+        std::memcpy(out + length, arg.data(), copy);
+        length += copy;
+    }
+    out[length] = '\0';
+    return length;
+}
+
+std::string formatLogLine(LogLine line, const std::string& arg) {
+    std::string text;
+    for (const char* c = logTemplate(line); *c; ++c) {
+        if (*c == '%') text += arg;
+        else text += *c;
+    }
+    return text;
+}
+
+void GameSession::start() {
+    log(LogLine::ADVENTURE_BEGINS);
+    isNewRoomEntry = true;
+    evaluateRoom();
+}
+
+namespace {
+    // FNV-1a, 64-bit.
+    const std::uint64_t HASH_SEED = 14695981039346656037ull;
+    void hashBytes(std::uint64_t& hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    void hashU32(std::uint64_t& hash, std::uint32_t value) { hashBytes(hash, &value, sizeof(value)); }
+    void hashText(std::uint64_t& hash, const std::string& text) {
+        hashU32(hash, static_cast<std::uint32_t>(text.size()));
+        hashBytes(hash, text.data(), text.size());
+    }
+}
+
+std::uint64_t Dungeon::layoutHash() const {
+    if (layoutHashed) return layoutHashValue;
+    std::uint64_t hash = HASH_SEED;
+    hashU32(hash, static_cast<std::uint32_t>(rooms.size()));
+    // Each changed room has exactly one baseline; index them once so the
+    // pass stays linear however much play has changed.
+    std::vector<const RoomBaseline*> baselineOf(changes.empty() ? 0 : rooms.size(), nullptr);
+    for (const RoomBaseline& baseline : changes) baselineOf[baseline.id] = &baseline;
+    for (size_t i = 0; i < rooms.size(); ++i) {
+        const Room& room = rooms[i];
+        const RoomBaseline* baseline = baselineOf.empty() ? nullptr : baselineOf[i];
+        StringId description = baseline ? baseline->descriptionId : room.descriptionId;
+        const Entity* entity = baseline ? baseline->entity : room.entity;
+        bool choice = baseline ? baseline->isChoiceRoom : room.isChoiceRoom;
+        hashText(hash, text(room.nameId));
+        hashText(hash, text(description));
+        hashText(hash, text(room.backgroundId));
+        hashU32(hash, (room.isFinalDoor ? 1u : 0u) | (choice ? 2u : 0u) | (room.isWeaponRoom ? 4u : 0u));
+        if (entity) {
+            const Enemy* enemy = entityCast<Enemy>(entity);
+            hashU32(hash, static_cast<std::uint32_t>(entity->getKind()) + 1);
+            hashText(hash, entity->getName());
+            hashU32(hash, enemy ? static_cast<std::uint32_t>(enemy->getDamage()) : 0u);
+        } else {
+            hashU32(hash, 0);
+        }
+    }
+    hashU32(hash, static_cast<std::uint32_t>(edges.size()));
+    for (const auto& edge : edges) {
+        hashU32(hash, edge.first);
+        hashU32(hash, edge.second);
+    }
+    layoutHashValue = hash;
+    layoutHashed = true;
+    return hash;
+}
+
+bool GameSession::inSwordRoomWithSword() const {
+    const Room* room = dungeon.getCurrentRoom();
+    return room && room->isWeaponRoom && entityCast<Weapon>(room->entity);
+}
+
+bool actionForKey(InteractionState state, char key, Action& action) {
+    switch (key) {
+        case 'F': case 'f': action = state == InteractionState::COMBAT ? Action::FIGHT : Action::FORWARD; return true;
+        case 'B': case 'b': action = Action::BACK; return true;
+        case 'C': case 'c': action = Action::COLLECT; return true;
+        case 'Q': case 'q': action = Action::QUIT; return true;
+        case 'R': case 'r': action = Action::RUN; return true;
+        case '1': action = Action::CHOOSE_KEY; return true;
+        case '2': action = Action::CHOOSE_POTION; return true;
+        case 'E': case 'e': action = Action::CONTINUE; return true;
+        default: return false;
+    }
+}
+
+bool GameSession::canApply(Action action) const {
+    if (isOver()) return false;
+    switch (action) {
+        case Action::FORWARD: return state == InteractionState::EXPLORING && (player.getMoves() <= 0 || dungeon.canMoveForward());
+        case Action::BACK: return state == InteractionState::EXPLORING && (player.getMoves() <= 0 || dungeon.canMoveBack());
+        case Action::COLLECT: return state == InteractionState::EXPLORING && inSwordRoomWithSword();
+        case Action::QUIT: return state == InteractionState::EXPLORING && !inSwordRoomWithSword();
+        case Action::FIGHT:
+        case Action::RUN: return state == InteractionState::COMBAT;
+        case Action::CHOOSE_KEY:
+        case Action::CHOOSE_POTION: return state == InteractionState::CHOICE;
+        case Action::CONTINUE: return state == InteractionState::MESSAGE;
+    }
+    return false;
+}
+
+// Instant actions end play on the spot; the GUI skips the room fade for them.
+bool GameSession::isInstant(Action action) const {
+    switch (action) {
+        case Action::RUN:
+        case Action::QUIT: return true;
+        case Action::FORWARD:
+        case Action::BACK: return player.getMoves() <= 0;
+        default: return false;
+    }
+}
+
+bool GameSession::apply(Action action) {
+    if (!canApply(action)) return false;
+
+    switch (action) {
+        case Action::FORWARD:
+        case Action::BACK:
+            if (player.getMoves() <= 0) {
+                finish(Outcome::OUT_OF_MOVES);
+                return true;
+            }
+            isNewRoomEntry = true;
+            if (action == Action::FORWARD) dungeon.moveForward();
+            else dungeon.moveBack();
+            break;
+        case Action::COLLECT:
+            {
+                Room* room = dungeon.getCurrentRoom();
+                player.collectItem(Items::SWORD);
+                log(LogLine::COLLECTED_SWORD);
+                dungeon.setDescription(*room, "You grasp the sword. A surge of ultimate power floods your veins.");
+                dungeon.clearEntity(*room);
+                dirtyFlags |= Dirty::ROOM;
+                setState(InteractionState::EXPLORING);
+            }
+            break;
+        case Action::QUIT:
+            finish(Outcome::QUIT);
+            return true;
+        case Action::FIGHT:
+            resolveCombat();
+            if (isOver()) return true;
+            break;
+        case Action::RUN:
+            log(LogLine::FLED);
+            finish(Outcome::FLED);
+            return true;
+        case Action::CHOOSE_KEY: resolveChoice(1); break;
+        case Action::CHOOSE_POTION: resolveChoice(2); break;
+        case Action::CONTINUE: setState(InteractionState::EXPLORING); break;
+    }
+    afterAction();
+    return true;
+}
+
+void GameSession::afterAction() {
+    // Moves may go negative on the last step; that is where the run ends.
+    if (player.getMoves() < 0) {
+        finish(Outcome::OUT_OF_MOVES);
+        return;
+    }
+    evaluateRoom();
+}
+
+void GameSession::evaluateRoom() {
+    Room* room = dungeon.getCurrentRoom();
+    if (!room) return;
+
+    if (isNewRoomEntry) {
+        log(LogLine::ENTERED_ROOM, dungeon.nameOf(*room));
+        isNewRoomEntry = false;
+    }
+
+    if (room->isFinalDoor) {
+        if (player.hasItem(Items::GOLDEN_KEY) && player.isFinalBossDefeated()) finish(Outcome::VICTORY);
+        else if (player.hasItem(Items::GOLDEN_KEY)) finish(Outcome::DOOR_LOCKED_BOSS_ALIVE);
+        else finish(Outcome::DOOR_LOCKED_NO_KEY);
+    }
+    else if (room->entity) {
+        if (inSwordRoomWithSword()) {
+            setState(InteractionState::EXPLORING);
+        }
+        else if (entityCast<Enemy>(room->entity)) {
+            setState(InteractionState::COMBAT);
+        }
+        else {
+            resolveItem();
+        }
+    }
+    else if (room->isChoiceRoom) { setState(InteractionState::CHOICE); }
+    else { setState(InteractionState::EXPLORING); }
+}
+
+void GameSession::resolveItem() {
+    Room* room = dungeon.getCurrentRoom();
+    if (!room || !room->entity) return;
+    Item* item = entityCast<Item>(room->entity);
+    if (!item) return;
+
+    std::string result;
+    item->interact(player, result);
+    log(LogLine::ITEM_RESULT, result);
+    dungeon.setDescription(*room, result);
+    dungeon.clearEntity(*room);
+    dirtyFlags |= Dirty::ROOM;
+
+    setState(InteractionState::EXPLORING);
+}
+
+void GameSession::resolveCombat() {
+    Room* room = dungeon.getCurrentRoom();
+    if (!room || !room->entity) return;
+    Enemy* enemy = entityCast<Enemy>(room->entity);
+    if(!enemy) return;
+
+    if (onLog) log(LogLine::FOUGHT, enemy->getName());
+    int effectiveDamage = enemy->getDamage();
+    message = "";
+    bool isBoss = enemy->getKind() == EntityKind::BOSS;
+
+    if (isBoss) {
+        if(player.hasItem(Items::SWORD)) {
+             message = "Your Sword glows, weakening the boss!\n";
+             effectiveDamage = 50;
+        } else {
+             message = "You are unarmed against the mighty boss!\n";
+        }
+    }
+
+    message += player.takeDamage(effectiveDamage);
+
+    if (player.getHealth() <= 0) {
+        if (onLog) log(LogLine::SLAIN_BY, enemy->getName());
+        finish(Outcome::DIED_IN_COMBAT);
+        return;
+    }
+
+    std::string enemyName = enemy->getName();
+    log(LogLine::DEFEATED, enemyName);
+    if (isBoss) {
+        player.setBossDefeated(true);
+        log(LogLine::BOSS_DEFEATED);
+    }
+
+    dungeon.setDescription(*room, "You defeated the " + enemyName + ". The way is clear. (You took " + std::to_string(effectiveDamage) + " damage)");
+
+    dungeon.clearEntity(*room);
+    dirtyFlags |= Dirty::ROOM;
+    setState(InteractionState::MESSAGE);
+}
+
+void GameSession::resolveChoice(int choice) {
+    Room* room = dungeon.getCurrentRoom();
+    if (!room || !room->isChoiceRoom) return;
+
+    if (choice == 1) {
+        player.collectItem(Items::GOLDEN_KEY);
+        log(LogLine::TOOK_KEY);
+        dungeon.setDescription(*room, "You took the Golden Key.");
+    } else {
+        player.heal(100);
+        log(LogLine::DRANK_POTION);
+        dungeon.setDescription(*room, "You drank the Health Potion.");
+    }
+    dungeon.clearChoice(*room);
+    dirtyFlags |= Dirty::ROOM;
+
+    setState(InteractionState::EXPLORING);
+}
+
+
+// =================================================================
+// 4. DUNGEON SETUP
+// =================================================================
+
+namespace {
+    struct RoomText { const char* name; const char* description; const char* backgroundID; };
+
+    // setupDungeon's rooms, in order.
+    const RoomText STOCK_ROOMS[] = {
+        {"Dungeon Entrance", "The heavy stone door slams shut behind you. Your only way is forward.", "dungeon.png"},
+        {"Sanctum of Fire and Frost", "You dare enter my domain, mortal? The fire and frost bend to my will. If you wish to pass, you must defeat me first.", "wizard.png"},
+        {"Dragon's Lair", "The air is hot and smells of sulfur. A scaly beast awakens from its slumber.", "dragon.png"},
+        {"Zombie's Crypt", "Dust swirls through shafts of cold light. From the gloom, a corpse lurches forward with dead, hungry eyes.", "zombie.png"},
+        {"Chamber of the Cursed Blades", "Dark swords float mid-air, glowing with runes. A red sigil burns behind them, pulsing with power.", "sword.png"},
+        {"Room of Choice", "The hooded figure looks up from his book. 'You can only take one,' he says. 'The golden key... or the potion that gives you health'", "potion.png"},
+        {"Giant Monster's Den", "Huge claw marks scar the walls. A hulking creature guards the path ahead.", "monster.png"},
+        {"Final Boss Chamber", "This is it. The final guardian.", "finalboss.png"},
+        {"The Final Door", "You see a massive, ornate door with a single large keyhole. This must be the exit.", "finaldoor.png"},
+    };
+    const int STOCK_ROOM_COUNT = sizeof(STOCK_ROOMS) / sizeof(STOCK_ROOMS[0]);
+    enum StockRoom { ENTRANCE, WIZARD_STUDY, DRAGON_LAIR, ZOMBIE_CRYPT, WEAPON_ROOM, CHOICE_ROOM, MONSTER_DEN, BOSS_CHAMBER, FINAL_DOOR };
+
+    // generateDungeon's shorter choice room; its other fixed rooms are the stock ones.
+    const RoomText GENERATED_CHOICE_ROOM = {"Room of Choice", "'You can only take one. The golden key... or the potion that gives you health'", "potion.png"};
+
+    struct MinionTemplate { const char* name; RoomText room; int damage; };
+    const MinionTemplate MINION_TEMPLATES[] = {
+        {"Wizard", {"Sanctum of Fire and Frost", "Fire and frost swirl around a robed figure.", "wizard.png"}, 10},
+        {"Dragon", {"Dragon's Lair", "The air is hot and smells of sulfur. A scaly beast awakens from its slumber.", "dragon.png"}, 15},
+        {"Zombie", {"Zombie's Crypt", "From the gloom, a corpse lurches forward with dead, hungry eyes.", "zombie.png"}, 5},
+        {"Giant Monster", {"Giant Monster's Den", "Huge claw marks scar the walls. A hulking creature guards the path ahead.", "monster.png"}, 10},
+    };
+    const int MINION_TEMPLATE_COUNT = sizeof(MINION_TEMPLATES) / sizeof(MINION_TEMPLATES[0]);
+
+    // Ids of a room's text in builtinText(), looked up once per process.
+    struct RoomTextIds { StringId name, description, background; };
+
+    RoomTextIds internRoomText(StringTable& table, const RoomText& text) {
+        return {table.intern(text.name), table.intern(text.description), table.intern(text.backgroundID)};
+    }
+
+    struct BuiltinIds {
+        RoomTextIds stock[STOCK_ROOM_COUNT];
+        RoomTextIds generatedChoice;
+        RoomTextIds minions[MINION_TEMPLATE_COUNT];
+    };
+
+    // Builds the shared table and the ids of every stock room in one go;
+    // the function-local static makes this run once, safely across threads.
+    const BuiltinIds& builtinIds(std::shared_ptr<const StringTable>* tableOut = nullptr) {
+        static std::shared_ptr<const StringTable> table;
+        static const BuiltinIds ids = [] {
+            auto building = std::make_shared<StringTable>();
+            BuiltinIds result;
+            for (int i = 0; i < STOCK_ROOM_COUNT; ++i) result.stock[i] = internRoomText(*building, STOCK_ROOMS[i]);
+            result.generatedChoice = internRoomText(*building, GENERATED_CHOICE_ROOM);
+            for (int i = 0; i < MINION_TEMPLATE_COUNT; ++i) result.minions[i] = internRoomText(*building, MINION_TEMPLATES[i].room);
+            table = building;
+            return result;
+        }();
+        if (tableOut) *tableOut = table;
+        return ids;
+    }
+
+    // Stock ids are only valid in dungeons layered on builtinText(); any
+    // other dungeon interns the text itself.
+    RoomId addRoom(Dungeon& dungeon, const RoomText& text, const RoomTextIds& ids, bool builtin) {
+        if (builtin) return dungeon.addRoom(ids.name, ids.description, ids.background);
+        return dungeon.addRoom(text.name, text.description, text.backgroundID);
+    }
+
+    bool usesBuiltinText(const Dungeon& dungeon) {
+        std::shared_ptr<const StringTable> shared = builtinText();
+        return dungeon.sharesText(shared.get());
+    }
+}
+
+std::shared_ptr<const StringTable> builtinText() {
+    std::shared_ptr<const StringTable> table;
+    builtinIds(&table);
+    return table;
+}
+
+void setupDungeon(Dungeon& dungeon) {
+    const BuiltinIds& ids = builtinIds();
+    bool builtin = usesBuiltinText(dungeon);
+    dungeon.reserve(STOCK_ROOM_COUNT, STOCK_ROOM_COUNT - 1);
+    RoomId rooms[STOCK_ROOM_COUNT];
+    for (int i = 0; i < STOCK_ROOM_COUNT; ++i) rooms[i] = addRoom(dungeon, STOCK_ROOMS[i], ids.stock[i], builtin);
+
+    dungeon.spawn<MinionEnemy>(rooms[WIZARD_STUDY], "Wizard", 10);
+    dungeon.spawn<MinionEnemy>(rooms[DRAGON_LAIR], "Dragon", 15);
+    dungeon.spawn<MinionEnemy>(rooms[ZOMBIE_CRYPT], "Zombie", 5);
+    dungeon.spawn<Weapon>(rooms[WEAPON_ROOM], "Sword");
+    dungeon.getRoom(rooms[WEAPON_ROOM]).isWeaponRoom = true;
+    dungeon.getRoom(rooms[CHOICE_ROOM]).isChoiceRoom = true;
+    dungeon.spawn<MinionEnemy>(rooms[MONSTER_DEN], "Giant Monster", 10);
+    dungeon.spawn<BossEnemy>(rooms[BOSS_CHAMBER], "Final Boss", 75);
+    dungeon.getRoom(rooms[FINAL_DOOR]).isFinalDoor = true;
+}
+
+void generateDungeon(Dungeon& dungeon, std::mt19937& rng, int minionCount) {
+    const BuiltinIds& ids = builtinIds();
+    bool builtin = usesBuiltinText(dungeon);
+    std::uniform_int_distribution<int> pickTemplate(0, MINION_TEMPLATE_COUNT - 1);
+    std::uniform_int_distribution<int> jitter(-2, 2);
+
+    minionCount = std::max(0, minionCount);
+    const size_t roomCount = static_cast<size_t>(minionCount) + 5;
+    dungeon.reserve(roomCount, roomCount - 1);
+
+    auto addMinion = [&]() {
+        int pick = pickTemplate(rng);
+        const MinionTemplate& t = MINION_TEMPLATES[pick];
+        RoomId room = addRoom(dungeon, t.room, ids.minions[pick], builtin);
+        dungeon.spawn<MinionEnemy>(room, t.name, std::max(1, t.damage + jitter(rng)));
+    };
+
+    addRoom(dungeon, STOCK_ROOMS[ENTRANCE], ids.stock[ENTRANCE], builtin);
+    int beforeChoice = minionCount / 2;
+    for (int i = 0; i < beforeChoice; ++i) addMinion();
+
+    RoomId weaponRoom = addRoom(dungeon, STOCK_ROOMS[WEAPON_ROOM], ids.stock[WEAPON_ROOM], builtin);
+    dungeon.spawn<Weapon>(weaponRoom, "Sword");
+    dungeon.getRoom(weaponRoom).isWeaponRoom = true;
+    RoomId choiceRoom = addRoom(dungeon, GENERATED_CHOICE_ROOM, ids.generatedChoice, builtin);
+    dungeon.getRoom(choiceRoom).isChoiceRoom = true;
+
+    for (int i = beforeChoice; i < minionCount; ++i) addMinion();
+
+    RoomId bossChamber = addRoom(dungeon, STOCK_ROOMS[BOSS_CHAMBER], ids.stock[BOSS_CHAMBER], builtin);
+    dungeon.spawn<BossEnemy>(bossChamber, "Final Boss", 75);
+    RoomId finalDoor = addRoom(dungeon, STOCK_ROOMS[FINAL_DOOR], ids.stock[FINAL_DOOR], builtin);
+    dungeon.getRoom(finalDoor).isFinalDoor = true;
+}
+
+// =================================================================
+// 5. SAVE SNAPSHOTS
+// =================================================================
+// Layout, native byte order (little-endian on every target):
+//   char[4] "DGSV", u32 version, u64 layoutHash (Dungeon::layoutHash)
+//   u8 state, u8 outcome, u8 newRoomEntry, str message
+//   u32 health, u32 moves, u8 bossDefeated, u8 itemCount, str item[itemCount]
+//   u32 currentRoom, u32 pathLength, u32 path[pathLength]     oldest first
+//   u32 changedRooms, then per room: u32 room, u8 flags, [str description]
+// A str is a u32 length and the bytes. Items are stored by name, since
+// item ids depend on the order names were first interned in a process.
+
+namespace {
+    const char SNAPSHOT_MAGIC[4] = {'D', 'G', 'S', 'V'};
+    const std::uint32_t SNAPSHOT_VERSION = 2;
+
+    enum SnapshotRoomFlags : std::uint8_t {
+        ENTITY_TAKEN = 1u << 0,
+        CHOICE_TAKEN = 1u << 1,
+        REDESCRIBED = 1u << 2,
+    };
+
+    void putU8(std::string& out, std::uint8_t value) { out.push_back(static_cast<char>(value)); }
+    void putU32(std::string& out, std::uint32_t value) { out.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void putU64(std::string& out, std::uint64_t value) { out.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void putString(std::string& out, const std::string& value) {
+        putU32(out, static_cast<std::uint32_t>(value.size()));
+        out += value;
+    }
+
+    // Bounds-checked cursor; after the first short read everything reads as
+    // zero and good() stays false.
+    class SnapshotReader {
+    private:
+        const char* cursor;
+        const char* end;
+        bool ok = true;
+    public:
+        explicit SnapshotReader(const std::string& data) : cursor(data.data()), end(data.data() + data.size()) {}
+        bool good() const { return ok; }
+        size_t remaining() const { return static_cast<size_t>(end - cursor); }
+
+        void read(void* out, size_t size) {
+            if (!ok || remaining() < size) { ok = false; std::memset(out, 0, size); return; }
+            std::memcpy(out, cursor, size);
+            cursor += size;
+        }
+        std::uint8_t u8() { std::uint8_t value; read(&value, sizeof(value)); return value; }
+        std::uint32_t u32() { std::uint32_t value; read(&value, sizeof(value)); return value; }
+        std::uint64_t u64() { std::uint64_t value; read(&value, sizeof(value)); return value; }
+        std::string string() {
+            std::uint32_t length = u32();
+            if (!ok || remaining() < length) { ok = false; return std::string(); }
+            std::string value(cursor, length);
+            cursor += length;
+            return value;
+        }
+    };
+
+    struct RoomChange {
+        RoomId room;
+        std::uint8_t flags;
+        std::string description;
+    };
+}
+
+void GameSession::saveSnapshot(std::string& out) const {
+    out.clear();
+    out.append(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    putU32(out, SNAPSHOT_VERSION);
+    putU64(out, dungeon.layoutHash());
+
+    putU8(out, static_cast<std::uint8_t>(state));
+    putU8(out, static_cast<std::uint8_t>(outcome));
+    putU8(out, isNewRoomEntry ? 1 : 0);
+    putString(out, message);
+
+    putU32(out, static_cast<std::uint32_t>(player.getHealth()));
+    putU32(out, static_cast<std::uint32_t>(player.getMoves()));
+    putU8(out, player.isFinalBossDefeated() ? 1 : 0);
+    const Inventory<ItemId>& inventory = player.getInventory();
+    putU8(out, static_cast<std::uint8_t>(inventory.size()));
+    inventory.forEach([&out](ItemId item) { putString(out, ItemRegistry::name(item)); });
+
+    const Stack<RoomId>& path = dungeon.getPath();
+    putU32(out, dungeon.getCurrentRoomId());
+    putU32(out, static_cast<std::uint32_t>(path.size()));
+    for (size_t i = 0; i < path.size(); ++i) putU32(out, path.at(i));
+
+    putU32(out, static_cast<std::uint32_t>(dungeon.changedRoomCount()));
+    for (size_t i = 0; i < dungeon.changedRoomCount(); ++i) {
+        const Dungeon::RoomBaseline& baseline = dungeon.changedRoom(i);
+        const Room& room = dungeon.getRoom(baseline.id);
+        std::uint8_t flags = 0;
+        if (baseline.entity && !room.entity) flags |= ENTITY_TAKEN;
+        if (baseline.isChoiceRoom && !room.isChoiceRoom) flags |= CHOICE_TAKEN;
+        if (room.descriptionId != baseline.descriptionId) flags |= REDESCRIBED;
+        putU32(out, baseline.id);
+        putU8(out, flags);
+        if (flags & REDESCRIBED) putString(out, dungeon.descriptionOf(room));
+    }
+}
+
+bool GameSession::restoreSnapshot(const std::string& snapshot, std::string& error) {
+    SnapshotReader in(snapshot);
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in.good() || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0) { error = "not a save snapshot"; return false; }
+    std::uint32_t version = in.u32();
+    if (version != SNAPSHOT_VERSION) { error = "unsupported snapshot version " + std::to_string(version); return false; }
+    if (in.u64() != dungeon.layoutHash()) { error = "snapshot is from a different dungeon"; return false; }
+    const size_t roomCount = dungeon.roomCount();
+
+    // Read and check everything before touching the session.
+    std::uint8_t savedState = in.u8();
+    std::uint8_t savedOutcome = in.u8();
+    bool savedNewRoomEntry = in.u8() != 0;
+    std::string savedMessage = in.string();
+
+    int health = static_cast<int>(in.u32());
+    int moves = static_cast<int>(in.u32());
+    bool bossDefeated = in.u8() != 0;
+    std::uint8_t itemCount = in.u8();
+    std::vector<std::string> items;
+    for (std::uint8_t i = 0; i < itemCount && in.good(); ++i) items.push_back(in.string());
+
+    RoomId current = in.u32();
+    std::uint32_t pathLength = in.u32();
+    if (pathLength > in.remaining() / sizeof(std::uint32_t)) { error = "snapshot is truncated"; return false; }
+    std::vector<RoomId> path(pathLength);
+    for (RoomId& id : path) id = in.u32();
+
+    std::uint32_t changeCount = in.u32();
+    if (changeCount > in.remaining() / (sizeof(std::uint32_t) + 1)) { error = "snapshot is truncated"; return false; }
+    std::vector<RoomChange> changes(changeCount);
+    for (RoomChange& change : changes) {
+        change.room = in.u32();
+        change.flags = in.u8();
+        if (change.flags & REDESCRIBED) change.description = in.string();
+    }
+
+    if (!in.good() || in.remaining() != 0) { error = "snapshot is truncated or has trailing bytes"; return false; }
+    bool valid = savedState <= static_cast<std::uint8_t>(InteractionState::MESSAGE)
+        && savedOutcome <= static_cast<std::uint8_t>(Outcome::QUIT)
+        && items.size() <= ItemRegistry::MAX_ITEMS
+        && current < roomCount;
+    for (RoomId id : path) valid = valid && id < roomCount;
+    for (const RoomChange& change : changes) valid = valid && change.room < roomCount;
+    if (!valid) { error = "snapshot holds out-of-range values"; return false; }
+
+    // Only items this process already knows can be held; a save never
+    // registers new kinds, so a forged one cannot fill the registry.
+    std::vector<ItemId> itemIds;
+    itemIds.reserve(items.size());
+    for (const std::string& item : items) {
+        ItemId id;
+        if (!ItemRegistry::find(item, id)) { error = "snapshot holds an unknown item: " + item; return false; }
+        if (std::find(itemIds.begin(), itemIds.end(), id) != itemIds.end()) { error = "snapshot holds an item twice: " + item; return false; }
+        itemIds.push_back(id);
+    }
+
+    dungeon.revertRooms();
+    for (const RoomChange& change : changes) {
+        Room& room = dungeon.getRoom(change.room);
+        if (change.flags & ENTITY_TAKEN) dungeon.clearEntity(room);
+        if (change.flags & CHOICE_TAKEN) dungeon.clearChoice(room);
+        if (change.flags & REDESCRIBED) dungeon.setDescription(room, change.description);
+    }
+    player.restore(health, moves, bossDefeated);
+    for (ItemId item : itemIds) player.collectItem(item);
+    dungeon.restorePosition(current, path);
+
+    state = static_cast<InteractionState>(savedState);
+    outcome = static_cast<Outcome>(savedOutcome);
+    isNewRoomEntry = savedNewRoomEntry;
+    message = savedMessage;
+    dirtyFlags = Dirty::ALL;
+    return true;
+}
@@ -0,0 +1,777 @@
+#ifndef CORE_HPP
+#define CORE_HPP
+
+// =================================================================
+// HEADLESS GAME CORE
+// Game rules and world state with no SFML dependency. Shared by the GUI
+// (main.cpp) and the headless simulation tools.
+// =================================================================
+
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <memory>
+#include <sstream>
+#include <functional>
+#include <random>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <bitset>
+#include <cstddef>
+#include <new>
+
+#if __cplusplus < 201402L
+// Provide make_unique for C++11
+namespace std {
+    template<typename T, typename... Args>
+    std::unique_ptr<T> make_unique(Args&&... args) {
+        return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
+    }
+}
+#endif
+
+// --- UI Invalidation Bits ---
+// Raised by the game logic whenever state shown on the HUD changes, and
+// consumed by GamePlayScreen::updateUI so only the affected parts are rebuilt.
+namespace Dirty {
+    const unsigned int NONE = 0;
+    const unsigned int STATS = 1 << 0;
+    const unsigned int INVENTORY = 1 << 1;
+    const unsigned int LOG = 1 << 2;
+    const unsigned int ROOM = 1 << 3;
+    const unsigned int INTERACTION = 1 << 4;
+    const unsigned int ALL = STATS | INVENTORY | LOG | ROOM | INTERACTION;
+}
+
+
+// =================================================================
+// 1. GAME LOGIC 
+// =================================================================
+
+class Player;
+class Dungeon;
+
+// --- Item Registry ---
+// Item names are interned process-wide to small ids, so inventories hold
+// bits rather than strings. The stock items have fixed ids for hot paths;
+// interning is thread-safe, and names already registered are found without
+// locking, so simulator workers building sessions do not contend.
+struct ItemId {
+    std::uint16_t value;
+    bool operator==(ItemId other) const { return value == other.value; }
+    bool operator!=(ItemId other) const { return value != other.value; }
+};
+
+namespace Items {
+    const ItemId SWORD{0};
+    const ItemId GOLDEN_KEY{1};
+}
+
+class ItemRegistry {
+public:
+    static const size_t MAX_ITEMS = 64;
+    static ItemId intern(const std::string& name);
+    // Looks a name up without registering it.
+    static bool find(const std::string& name, ItemId& id);
+    // Registers every name or, if they would not all fit, none of them.
+    static bool internAll(const std::vector<std::string>& names);
+    static const std::string& name(ItemId id);
+};
+
+// Concrete entity kinds, grouped so each class covers a contiguous range.
+// entityCast<T> compares the tag against T::matches() instead of walking
+// RTTI; a new kind needs only its enumerator and its class's matches().
+enum class EntityKind : std::uint8_t { ITEM, WEAPON, POTION, KEY, MINION, BOSS };
+
+class Entity {
+private:
+    EntityKind kind;
+protected:
+    explicit Entity(EntityKind k) : kind(k) {}
+public:
+    virtual ~Entity() = default;
+    EntityKind getKind() const { return kind; }
+    virtual std::string getDescription() const = 0;
+    virtual void interact(Player& player, std::string& interactionResult) = 0;
+    virtual std::string getName() const = 0;
+};
+
+template <typename T>
+T* entityCast(Entity* entity) { return entity && T::matches(entity->getKind()) ? static_cast<T*>(entity) : nullptr; }
+template <typename T>
+const T* entityCast(const Entity* entity) { return entity && T::matches(entity->getKind()) ? static_cast<const T*>(entity) : nullptr; }
+
+class Item : public Entity {
+protected:
+    std::string name;
+    ItemId itemId;
+public:
+    explicit Item(std::string n, EntityKind k = EntityKind::ITEM) : Entity(k), name(std::move(n)), itemId(ItemRegistry::intern(name)) {}
+    static bool matches(EntityKind k) { return k >= EntityKind::ITEM && k <= EntityKind::KEY; }
+    std::string getName() const override { return name; }
+    ItemId getItemId() const { return itemId; }
+    void interact(Player& player, std::string& interactionResult) override;
+    std::string getDescription() const override { return "You see a " + name + "."; }
+};
+
+class Weapon : public Item {
+public:
+    explicit Weapon(std::string n) : Item(std::move(n), EntityKind::WEAPON) {}
+    static bool matches(EntityKind k) { return k == EntityKind::WEAPON; }
+    std::string getDescription() const override { return "A powerful " + name + " rests here."; }
+};
+
+class Potion : public Item {
+public:
+    explicit Potion(std::string n) : Item(std::move(n), EntityKind::POTION) {}
+    static bool matches(EntityKind k) { return k == EntityKind::POTION; }
+    void interact(Player& player, std::string& interactionResult) override;
+    std::string getDescription() const override { return "A bubbling " + name + " is on a pedestal.";}
+};
+
+class Key : public Item {
+public:
+    explicit Key(std::string n) : Item(std::move(n), EntityKind::KEY) {}
+    static bool matches(EntityKind k) { return k == EntityKind::KEY; }
+    std::string getDescription() const override { return "A shiny " + name + " catches your eye.";}
+};
+
+class Enemy : public Entity {
+protected:
+    std::string name;
+    int damage;
+    Enemy(std::string n, int d, EntityKind k) : Entity(k), name(std::move(n)), damage(d) {}
+public:
+    static bool matches(EntityKind k) { return k == EntityKind::MINION || k == EntityKind::BOSS; }
+    std::string getName() const override { return name; }
+    int getDamage() const { return damage; }
+    void setDamage(int d) { damage = d; }
+    std::string getDescription() const override { return "DANGER! A " + name + " blocks your path."; }
+    void interact(Player& player, std::string& interactionResult) override;
+};
+
+class MinionEnemy : public Enemy {
+public:
+    MinionEnemy(std::string n, int d) : Enemy(std::move(n), d, EntityKind::MINION) {}
+    static bool matches(EntityKind k) { return k == EntityKind::MINION; }
+};
+
+class BossEnemy : public Enemy {
+public:
+    BossEnemy(std::string n, int d) : Enemy(std::move(n), d, EntityKind::BOSS) {}
+    static bool matches(EntityKind k) { return k == EntityKind::BOSS; }
+    void interact(Player& player, std::string& interactionResult) override;
+};
+
+// Arena for a dungeon's entities. Objects are placed back to back in large
+// blocks, so populating a room costs no allocation of its own, and they are
+// all destroyed with the pool. Removing an entity from a room just clears
+// the room's pointer.
+class EntityPool {
+private:
+    static const size_t BLOCK_SIZE = 64 * 1024;
+    std::vector<std::unique_ptr<unsigned char[]>> blocks;
+    size_t blockUsed = BLOCK_SIZE;
+    std::vector<Entity*> live;
+public:
+    EntityPool() = default;
+    ~EntityPool() { for (Entity* entity : live) entity->~Entity(); }
+    EntityPool(const EntityPool&) = delete;
+    EntityPool& operator=(const EntityPool&) = delete;
+
+    void reserve(size_t count) { live.reserve(count); }
+    size_t size() const { return live.size(); }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(sizeof(T) <= BLOCK_SIZE, "Entity too large for the pool");
+        const size_t align = alignof(std::max_align_t);
+        const size_t footprint = (sizeof(T) + align - 1) / align * align;
+        if (blockUsed + footprint > BLOCK_SIZE) {
+            blocks.emplace_back(new unsigned char[BLOCK_SIZE]);
+            blockUsed = 0;
+        }
+        T* entity = new (blocks.back().get() + blockUsed) T(std::forward<Args>(args)...);
+        blockUsed += footprint;
+        live.push_back(entity);
+        return entity;
+    }
+};
+
+// Contiguous stack. Unbounded, it doubles its buffer when full, so pushes
+// stop allocating once it has grown to the deepest history seen. With a
+// maximum depth it becomes a fixed ring allocated once: pushing onto a full
+// ring drops the oldest entry, keeping memory constant for long sessions.
+template <typename T>
+class Stack {
+private:
+    T* items = nullptr;
+    size_t capacity = 0;
+    size_t bottom = 0; // Ring index of the oldest entry.
+    size_t count = 0;
+    size_t maxDepth = 0; // 0 = unbounded.
+
+    size_t slot(size_t i) const { size_t index = bottom + i; return index >= capacity ? index - capacity : index; }
+    void reallocate(size_t newCapacity) {
+        T* newItems = new T[newCapacity];
+        size_t keep = std::min(count, newCapacity);
+        for (size_t i = 0; i < keep; ++i) newItems[i] = items[slot(count - keep + i)];
+        delete[] items;
+        items = newItems;
+        capacity = newCapacity;
+        bottom = 0;
+        count = keep;
+    }
+public:
+    explicit Stack(size_t depthLimit = 0) { setMaxDepth(depthLimit); }
+    ~Stack() { delete[] items; }
+    Stack(const Stack&) = delete;
+    Stack& operator=(const Stack&) = delete;
+    Stack(Stack&&) = delete;
+    Stack& operator=(Stack&&) = delete;
+
+    // Switches between unbounded (0) and ring mode, keeping the newest entries.
+    void setMaxDepth(size_t depthLimit) {
+        maxDepth = depthLimit;
+        if (maxDepth > 0 && capacity != maxDepth) reallocate(maxDepth);
+    }
+    size_t getMaxDepth() const { return maxDepth; }
+
+    void push(const T& value) {
+        if (count == capacity) {
+            if (maxDepth > 0) {
+                items[bottom] = value;
+                bottom = slot(1);
+                return;
+            }
+            reallocate(capacity == 0 ? 8 : capacity * 2);
+        }
+        items[slot(count)] = value;
+        count++;
+    }
+    void pop() { if (!isEmpty()) count--; }
+    void clear() { count = 0; bottom = 0; }
+    T& top() const { if (isEmpty()) throw std::runtime_error("Stack is empty."); return items[slot(count - 1)]; }
+    const T& at(size_t i) const { return items[slot(i)]; } // 0 is the oldest entry.
+    bool isEmpty() const { return count == 0; }
+    size_t size() const { return count; }
+};
+
+template <typename T>
+class Inventory {
+private:
+    T* items = nullptr;
+    size_t current_size = 0;
+    size_t capacity = 0;
+    void resize() {
+        capacity = (capacity == 0) ? 2 : capacity * 2;
+        T* newItems = new T[capacity];
+        for (size_t i = 0; i < current_size; ++i) newItems[i] = items[i];
+        delete[] items;
+        items = newItems;
+    }
+public:
+    Inventory() = default;
+    ~Inventory() { delete[] items; }
+    Inventory(const Inventory& other) : current_size(other.current_size), capacity(other.capacity) {
+        items = new T[capacity];
+        for (size_t i = 0; i < current_size; ++i) items[i] = other.items[i];
+    }
+    Inventory& operator=(const Inventory& other) {
+        if (this == &other) return *this;
+        delete[] items;
+        current_size = other.current_size;
+        capacity = other.capacity;
+        items = new T[capacity];
+        for (size_t i = 0; i < current_size; ++i) items[i] = other.items[i];
+        return *this;
+    }
+
+    void add(const T& item) { if (current_size == capacity) resize(); items[current_size++] = item; }
+    bool has(const T& item) const {
+        for (size_t i = 0; i < current_size; ++i) if (items[i] == item) return true;
+        return false;
+    }
+    size_t size() const { return current_size; }
+    std::string getSortedString() const {
+        if (current_size == 0) return "Empty";
+        T* sorted = new T[current_size];
+        for (size_t i = 0; i < current_size; ++i) sorted[i] = items[i];
+        std::sort(sorted, sorted + current_size);
+        std::stringstream ss;
+        for (size_t i = 0; i < current_size; ++i) ss << sorted[i] << (i == current_size - 1 ? "" : ", ");
+        delete[] sorted;
+        return ss.str();
+    }
+};
+
+// Inventory of interned items: O(1) membership and a display string that is
+// rebuilt only after the contents change. Each kind of item is held once.
+template <>
+class Inventory<ItemId> {
+private:
+    std::bitset<ItemRegistry::MAX_ITEMS> items;
+    mutable std::string sortedCache;
+    mutable bool cacheValid = false;
+public:
+    void add(ItemId item) { if (!items.test(item.value)) { items.set(item.value); cacheValid = false; } }
+    bool has(ItemId item) const { return items.test(item.value); }
+    size_t size() const { return items.count(); }
+    void clear() { items.reset(); cacheValid = false; }
+    template <typename F>
+    void forEach(F visit) const {
+        for (std::uint16_t i = 0; i < ItemRegistry::MAX_ITEMS; ++i) {
+            if (items.test(i)) visit(ItemId{i});
+        }
+    }
+    const std::string& getSortedString() const {
+        if (cacheValid) return sortedCache;
+        if (items.none()) sortedCache = "Empty";
+        else {
+            const std::string* names[ItemRegistry::MAX_ITEMS];
+            size_t count = 0;
+            for (std::uint16_t i = 0; i < ItemRegistry::MAX_ITEMS; ++i) {
+                if (items.test(i)) names[count++] = &ItemRegistry::name(ItemId{i});
+            }
+            std::sort(names, names + count, [](const std::string* a, const std::string* b) { return *a < *b; });
+            sortedCache.clear();
+            for (size_t i = 0; i < count; ++i) {
+                if (i) sortedCache += ", ";
+                sortedCache += *names[i];
+            }
+        }
+        cacheValid = true;
+        return sortedCache;
+    }
+};
+
+class Player {
+private:
+    std::string name;
+    int health;
+    int moves;
+    Inventory<ItemId> inventory;
+    bool finalBossDefeated = false;
+    unsigned int dirtyFlags = Dirty::ALL;
+public:
+    Player(std::string n, int h, int m) : name(std::move(n)), health(h), moves(m) {}
+
+    std::string getName() const { return name; }
+    int getHealth() const { return health; }
+    int getMoves() const { return moves; }
+    bool isFinalBossDefeated() const { return finalBossDefeated; }
+    const Inventory<ItemId>& getInventory() const { return inventory; }
+
+    unsigned int consumeDirty() { unsigned int flags = dirtyFlags; dirtyFlags = Dirty::NONE; return flags; }
+
+    std::string takeDamage(int damage) {
+        health -= damage;
+        if (health < 0) health = 0;
+        dirtyFlags |= Dirty::STATS;
+        std::stringstream ss;
+        ss << "You took " << damage << " damage!";
+        return ss.str();
+    }
+    void heal(int amount) { health = std::min(100, health + amount); dirtyFlags |= Dirty::STATS; }
+    void useMove() { moves--; dirtyFlags |= Dirty::STATS; } // Allow moves to go into negative to detect game over.
+    void collectItem(ItemId item) { inventory.add(item); dirtyFlags |= Dirty::INVENTORY; }
+    void collectItem(const std::string& item) { collectItem(ItemRegistry::intern(item)); }
+    bool hasItem(ItemId item) const { return inventory.has(item); }
+    // Unknown names are simply not held; looking them up registers nothing.
+    bool hasItem(const std::string& item) const {
+        ItemId id;
+        return ItemRegistry::find(item, id) && inventory.has(id);
+    }
+    void setBossDefeated(bool status) { finalBossDefeated = status; }
+    // Snapshot restore; the name is not part of a snapshot.
+    void restore(int h, int m, bool bossDefeated) {
+        health = h;
+        moves = m;
+        finalBossDefeated = bossDefeated;
+        inventory.clear();
+        dirtyFlags = Dirty::ALL;
+    }
+
+    // Sessions are saved and branched with snapshots, not by copying.
+    Player(const Player&) = delete;
+    Player& operator=(const Player&) = delete;
+};
+
+// --- String Table ---
+// Room text is interned per dungeon; rooms carry 4-byte ids, and the
+// template names and descriptions shared by thousands of generated rooms
+// are stored a single time. A table can sit on top of a shared, read-only
+// base (see builtinText()) so sessions built from the stock layouts
+// allocate nothing for their text; only strings created during play, like
+// combat results, land in the table itself.
+typedef std::uint32_t StringId;
+
+class StringTable {
+private:
+    std::shared_ptr<const StringTable> base;
+    StringId baseCount = 0;
+    std::unordered_map<std::string, StringId> ids;
+    std::vector<const std::string*> strings; // Points at the keys of `ids`; map nodes never move.
+public:
+    explicit StringTable(std::shared_ptr<const StringTable> shared = nullptr)
+        : base(std::move(shared)), baseCount(base ? static_cast<StringId>(base->size()) : 0) {}
+
+    bool find(const std::string& text, StringId& id) const {
+        if (base && base->find(text, id)) return true;
+        auto it = ids.find(text);
+        if (it == ids.end()) return false;
+        id = it->second;
+        return true;
+    }
+    StringId intern(const std::string& text) {
+        StringId id;
+        if (find(text, id)) return id;
+        id = baseCount + static_cast<StringId>(strings.size());
+        strings.push_back(&ids.emplace(text, id).first->first);
+        return id;
+    }
+    const std::string& get(StringId id) const { return id < baseCount ? base->get(id) : *strings[id - baseCount]; }
+    size_t size() const { return baseCount + strings.size(); }
+    bool sharesBase(const StringTable* shared) const { return base.get() == shared; }
+};
+
+// Every string the stock layouts (setupDungeon, generateDungeon) use.
+std::shared_ptr<const StringTable> builtinText();
+
+typedef std::uint32_t RoomId;
+const RoomId NO_ROOM = static_cast<RoomId>(-1);
+
+// Rooms live contiguously inside their Dungeon and are addressed by RoomId.
+// Text goes through Dungeon::text(); exits through Dungeon::getExit().
+class Room {
+public:
+    StringId nameId;
+    StringId descriptionId;
+    StringId backgroundId;
+    int backgroundHandle = -1; // Front-end resource handle for the background, resolved on first use.
+    bool isFinalDoor = false;
+    bool isChoiceRoom = false;
+    bool isWeaponRoom = false; // Its weapon can be taken, and it cannot be fled from while there.
+    bool changed = false; // Altered by play since it was built; see Dungeon::touch().
+    Entity* entity = nullptr; // Owned by the dungeon's EntityPool.
+
+    Room(StringId n, StringId d, StringId bg) : nameId(n), descriptionId(d), backgroundId(bg) {}
+};
+
+class Dungeon {
+private:
+    StringTable strings;
+    EntityPool entities;
+    std::vector<Room> rooms;
+    // Edges in insertion order. They are packed into compressed rows
+    // (edgeStart/edgeTarget) on the first query after a change, so exits
+    // of a room are contiguous and exit 0 is the first edge added.
+    std::vector<std::pair<RoomId, RoomId>> edges;
+    mutable std::vector<std::uint32_t> edgeStart; // rooms.size() + 1 offsets into edgeTarget.
+    mutable std::vector<RoomId> edgeTarget;
+    mutable bool edgesPacked = true;
+    mutable std::uint64_t layoutHashValue = 0;
+    mutable bool layoutHashed = false;
+    RoomId currentRoom = NO_ROOM;
+    Player& player;
+    Stack<RoomId> path_tracker;
+    unsigned int dirtyFlags = Dirty::ALL;
+
+public:
+    // A room as it was built, kept from the first time play changes it.
+    struct RoomBaseline {
+        RoomId id;
+        Entity* entity;
+        StringId descriptionId;
+        bool isChoiceRoom;
+    };
+
+private:
+    std::vector<RoomBaseline> changes;
+
+    void touch(Room& room) {
+        if (room.changed) return;
+        room.changed = true;
+        changes.push_back({static_cast<RoomId>(&room - rooms.data()), room.entity, room.descriptionId, room.isChoiceRoom});
+    }
+
+    void packEdges() const {
+        if (edgesPacked) return;
+        edgeStart.assign(rooms.size() + 1, 0);
+        for (const auto& edge : edges) edgeStart[edge.first + 1]++;
+        for (size_t i = 0; i < rooms.size(); ++i) edgeStart[i + 1] += edgeStart[i];
+        edgeTarget.resize(edges.size());
+        std::vector<std::uint32_t> cursor(edgeStart.begin(), edgeStart.end() - 1);
+        for (const auto& edge : edges) edgeTarget[cursor[edge.first]++] = edge.second;
+        edgesPacked = true;
+    }
+
+public:
+    // Fired after every move, e.g. so a front-end can prefetch neighbouring rooms.
+    std::function<void(Dungeon&)> onRoomChanged;
+
+    explicit Dungeon(Player& p, std::shared_ptr<const StringTable> sharedText = builtinText()) : strings(std::move(sharedText)), player(p) {}
+    Dungeon(const Dungeon&) = delete;
+    Dungeon& operator=(const Dungeon&) = delete;
+
+    void reserve(size_t roomCount, size_t edgeCount) {
+        rooms.reserve(roomCount);
+        edges.reserve(edgeCount);
+        entities.reserve(roomCount);
+    }
+
+    StringId intern(const std::string& value) { return strings.intern(value); }
+    const std::string& text(StringId id) const { return strings.get(id); }
+    size_t stringCount() const { return strings.size(); }
+    bool sharesText(const StringTable* shared) const { return strings.sharesBase(shared); }
+
+    // Appends a room and, unless told otherwise, makes it the first exit of
+    // the previously added room. The first room added is where play starts.
+    RoomId addRoom(StringId name, StringId description, StringId background, bool linkFromPrevious = true) {
+        RoomId id = static_cast<RoomId>(rooms.size());
+        rooms.emplace_back(name, description, background);
+        edgesPacked = false;
+        layoutHashed = false;
+        if (id == 0) currentRoom = 0;
+        else if (linkFromPrevious) addEdge(id - 1, id);
+        return id;
+    }
+    RoomId addRoom(const std::string& name, const std::string& description, const std::string& backgroundID, bool linkFromPrevious = true) {
+        return addRoom(intern(name), intern(description), intern(backgroundID), linkFromPrevious);
+    }
+    // Creates an entity in the dungeon's pool and places it in a room.
+    template <typename T, typename... Args>
+    T* spawn(RoomId id, Args&&... args) {
+        T* entity = entities.create<T>(std::forward<Args>(args)...);
+        rooms[id].entity = entity;
+        layoutHashed = false;
+        return entity;
+    }
+
+    void addEdge(RoomId from, RoomId to) {
+        edges.emplace_back(from, to);
+        edgesPacked = false;
+        layoutHashed = false;
+    }
+
+    size_t roomCount() const { return rooms.size(); }
+    size_t edgeCount() const { return edges.size(); }
+    // Fingerprint of the layout as built: room text, flags and entities
+    // (ignoring what play has changed) and the edges. Text is hashed by
+    // content, so it does not depend on interning order. Worked out on the
+    // first call after a room, edge or entity is added.
+    std::uint64_t layoutHash() const;
+    Room& getRoom(RoomId id) { return rooms[id]; }
+    const Room& getRoom(RoomId id) const { return rooms[id]; }
+    size_t exitCount(RoomId id) const { packEdges(); return edgeStart[id + 1] - edgeStart[id]; }
+    RoomId getExit(RoomId id, size_t exit) const { packEdges(); return edgeTarget[edgeStart[id] + exit]; }
+
+    RoomId getCurrentRoomId() const { return currentRoom; }
+    Room* getCurrentRoom() { return currentRoom == NO_ROOM ? nullptr : &rooms[currentRoom]; }
+    const Room* getCurrentRoom() const { return currentRoom == NO_ROOM ? nullptr : &rooms[currentRoom]; }
+    Room* getPreviousRoom() { return path_tracker.isEmpty() ? nullptr : &rooms[path_tracker.top()]; }
+    Room* getNextRoom() { return canMoveForward() ? &rooms[getExit(currentRoom, 0)] : nullptr; }
+    bool canMoveBack() const { return !path_tracker.isEmpty(); }
+    // Bounds how many moves can be backtracked; 0 (the default) keeps the whole path.
+    void setUndoDepth(size_t depth) { path_tracker.setMaxDepth(depth); }
+    bool canMoveForward() const { return currentRoom != NO_ROOM && exitCount(currentRoom) > 0; }
+    unsigned int consumeDirty() { unsigned int flags = dirtyFlags; dirtyFlags = Dirty::NONE; return flags; }
+
+    const std::string& nameOf(const Room& room) const { return text(room.nameId); }
+    const std::string& descriptionOf(const Room& room) const { return text(room.descriptionId); }
+    const std::string& backgroundOf(const Room& room) const { return text(room.backgroundId); }
+
+    // --- Room mutations ---
+    // Play changes rooms only through these, so a snapshot needs to record
+    // just the rooms that differ from the layout rather than all of them.
+    void setDescription(Room& room, const std::string& description) { touch(room); room.descriptionId = intern(description); }
+    void clearEntity(Room& room) { touch(room); room.entity = nullptr; }
+    void clearChoice(Room& room) { touch(room); room.isChoiceRoom = false; }
+    size_t changedRoomCount() const { return changes.size(); }
+    const RoomBaseline& changedRoom(size_t i) const { return changes[i]; }
+    void revertRooms() {
+        for (const RoomBaseline& baseline : changes) {
+            Room& room = rooms[baseline.id];
+            room.entity = baseline.entity;
+            room.descriptionId = baseline.descriptionId;
+            room.isChoiceRoom = baseline.isChoiceRoom;
+            room.changed = false;
+        }
+        changes.clear();
+        dirtyFlags |= Dirty::ROOM | Dirty::INTERACTION;
+    }
+
+    const Stack<RoomId>& getPath() const { return path_tracker; }
+    // Puts the player in `current` with `path` (oldest first) as the way back.
+    void restorePosition(RoomId current, const std::vector<RoomId>& path) {
+        currentRoom = current;
+        path_tracker.clear();
+        for (RoomId id : path) path_tracker.push(id);
+        dirtyFlags |= Dirty::ROOM | Dirty::INTERACTION;
+        if (onRoomChanged) onRoomChanged(*this);
+    }
+
+    void moveForward(size_t exit = 0) {
+        if (canMoveForward() && exit < exitCount(currentRoom)) {
+            player.useMove();
+            path_tracker.push(currentRoom);
+            currentRoom = getExit(currentRoom, exit);
+            dirtyFlags |= Dirty::ROOM | Dirty::INTERACTION;
+            if (onRoomChanged) onRoomChanged(*this);
+        }
+    }
+
+    void moveBack() {
+        if (canMoveBack()) {
+            player.useMove();
+            currentRoom = path_tracker.top();
+            path_tracker.pop();
+            dirtyFlags |= Dirty::ROOM | Dirty::INTERACTION;
+            if (onRoomChanged) onRoomChanged(*this);
+        }
+    }
+};
+
+// =================================================================
+// 1b. GAME SESSION (Rules & Action API)
+// =================================================================
+
+// --- Interaction States ---
+enum class InteractionState { EXPLORING, COMBAT, CHOICE, MESSAGE };
+
+// --- Player Actions ---
+enum class Action {
+    FORWARD,
+    BACK,
+    FIGHT,
+    RUN,
+    CHOOSE_KEY,
+    CHOOSE_POTION,
+    COLLECT,
+    CONTINUE,
+    QUIT
+};
+
+// Every action but QUIT, for strategies and searches that try them in turn.
+const Action ALL_ACTIONS[] = {
+    Action::FORWARD, Action::BACK, Action::FIGHT, Action::RUN,
+    Action::CHOOSE_KEY, Action::CHOOSE_POTION, Action::COLLECT, Action::CONTINUE
+};
+
+// The gameplay key bindings, with keys as characters: F B C Q R 1 2, and
+// E for Enter. F fights in combat and moves forward otherwise. Returns
+// false for a key that is not bound.
+bool actionForKey(InteractionState state, char key, Action& action);
+
+// --- Session Outcomes ---
+enum class Outcome {
+    NONE,
+    VICTORY,
+    DIED_IN_COMBAT,
+    OUT_OF_MOVES,
+    FLED,
+    DOOR_LOCKED_NO_KEY,
+    DOOR_LOCKED_BOSS_ALIVE,
+    QUIT
+};
+
+const char* outcomeReason(Outcome outcome);
+
+// --- Action Log Lines ---
+// A log line is a fixed template plus at most one argument, so front-ends
+// can format it straight into their own storage instead of receiving a
+// freshly concatenated string. '%' in a template stands for the argument.
+enum class LogLine : std::uint8_t {
+    ADVENTURE_BEGINS,
+    ENTERED_ROOM,
+    COLLECTED_SWORD,
+    ITEM_RESULT,
+    FLED,
+    FOUGHT,
+    SLAIN_BY,
+    DEFEATED,
+    BOSS_DEFEATED,
+    TOOK_KEY,
+    DRANK_POTION
+};
+
+const char* logTemplate(LogLine line);
+// Writes `format` with '%' replaced by `arg` into `out`, truncating to fit
+// `capacity` (which includes the terminating NUL). Returns the length.
+size_t formatLogLine(const char* format, const std::string& arg, char* out, size_t capacity);
+std::string formatLogLine(LogLine line, const std::string& arg);
+
+// Owns one playthrough: the player, the dungeon and the interaction state.
+// Front-ends translate their input into Actions and render from the getters.
+class GameSession {
+private:
+    Player player;
+    Dungeon dungeon;
+    InteractionState state = InteractionState::EXPLORING;
+    Outcome outcome = Outcome::NONE;
+    std::string message;
+    bool isNewRoomEntry = true;
+    unsigned int dirtyFlags = Dirty::ALL;
+
+    void log(LogLine line, const std::string& arg = std::string()) { if (onLog) onLog(line, arg); }
+    void setState(InteractionState newState) { state = newState; dirtyFlags |= Dirty::INTERACTION; }
+    void finish(Outcome result) { outcome = result; }
+    void afterAction();
+    void evaluateRoom();
+    void resolveItem();
+    void resolveCombat();
+    void resolveChoice(int choice);
+
+public:
+    // Receives every action-log line as its template and argument. Left
+    // empty, no log arguments are built.
+    std::function<void(LogLine, const std::string&)> onLog;
+
+    GameSession(std::string playerName, int health, int moves) : player(std::move(playerName), health, moves), dungeon(player) {}
+    GameSession(const GameSession&) = delete;
+    GameSession& operator=(const GameSession&) = delete;
+
+    void start();
+    bool canApply(Action action) const;
+    bool isInstant(Action action) const;
+    bool apply(Action action);
+
+    bool inSwordRoomWithSword() const;
+    bool isOver() const { return outcome != Outcome::NONE; }
+    Outcome getOutcome() const { return outcome; }
+    InteractionState getState() const { return state; }
+    const std::string& getMessage() const { return message; }
+    Player& getPlayer() { return player; }
+    const Player& getPlayer() const { return player; }
+    Dungeon& getDungeon() { return dungeon; }
+    const Dungeon& getDungeon() const { return dungeon; }
+    unsigned int consumeDirty() {
+        unsigned int flags = dirtyFlags | player.consumeDirty() | dungeon.consumeDirty();
+        dirtyFlags = Dirty::NONE;
+        return flags;
+    }
+
+    // --- Snapshots ---
+    // A snapshot is a small versioned blob of everything play changes: the
+    // interaction state, the player's stats and items, the position and way
+    // back, and the rooms that were cleared or re-described. It restores
+    // into any session built from the same layout, so a search can branch
+    // from one state without copying the Player or rebuilding the dungeon.
+    // `out` is overwritten, and keeps its capacity between saves.
+    void saveSnapshot(std::string& out) const;
+    // Leaves the session untouched and sets `error` if the blob is damaged,
+    // from another version or from a different layout.
+    bool restoreSnapshot(const std::string& snapshot, std::string& error);
+};
+
+void setupDungeon(Dungeon& dungeon);
+
+// Builds a random linear dungeon: `minionCount` minion rooms split around the
+// sword and choice rooms, then the boss and the final door. Text is interned
+// once up front, so even 10^6 rooms build in a single pass with no rehashing.
+void generateDungeon(Dungeon& dungeon, std::mt19937& rng, int minionCount);
+
+#endif // CORE_HPP
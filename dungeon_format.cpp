@@ -0,0 +1,278 @@
+#include "dungeon_format.hpp"
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+// =================================================================
+// DUNGEON DEFINITIONS (see dungeon_format.hpp for both formats)
+// =================================================================
+
+namespace {
+    using namespace DungeonFormat;
+
+    struct SourceExit {
+        std::string room;
+        int line;
+    };
+
+    struct SourceRoom {
+        std::string name;
+        std::string description;
+        std::string background;
+        std::uint32_t entity = NO_ENTITY;
+        std::uint32_t flags = 0;
+        bool detached = false;
+        std::vector<SourceExit> exits;
+        int line = 0;
+    };
+
+    class StringPool {
+    private:
+        std::unordered_map<std::string, std::uint32_t> ids;
+    public:
+        std::vector<std::string> strings;
+        std::uint32_t add(const std::string& text) {
+            auto it = ids.find(text);
+            if (it != ids.end()) return it->second;
+            std::uint32_t id = static_cast<std::uint32_t>(strings.size());
+            ids.emplace(text, id);
+            strings.push_back(text);
+            return id;
+        }
+    };
+
+    template <typename T>
+    void append(std::string& out, const T& value) { out.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    template <typename T>
+    T readRecord(const char* at) {
+        T value;
+        std::memcpy(&value, at, sizeof(T));
+        return value;
+    }
+
+    std::string trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) return "";
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool entityKindFor(const std::string& word, EntityKind& kind) {
+        static const struct { const char* word; EntityKind kind; } kinds[] = {
+            {"item", EntityKind::ITEM}, {"weapon", EntityKind::WEAPON}, {"potion", EntityKind::POTION},
+            {"key", EntityKind::KEY}, {"minion", EntityKind::MINION}, {"boss", EntityKind::BOSS},
+        };
+        for (const auto& entry : kinds) {
+            if (word == entry.word) { kind = entry.kind; return true; }
+        }
+        return false;
+    }
+
+    bool failAt(int line, const std::string& message, std::string& error) {
+        error = "line " + std::to_string(line) + ": " + message;
+        return false;
+    }
+
+    void spawnEntity(Dungeon& dungeon, RoomId room, const EntityRecord& record, const std::string& name) {
+        switch (static_cast<EntityKind>(record.kind)) {
+            case EntityKind::ITEM: dungeon.spawn<Item>(room, name); break;
+            case EntityKind::WEAPON: dungeon.spawn<Weapon>(room, name); break;
+            case EntityKind::POTION: dungeon.spawn<Potion>(room, name); break;
+            case EntityKind::KEY: dungeon.spawn<Key>(room, name); break;
+            case EntityKind::MINION: dungeon.spawn<MinionEnemy>(room, name, record.damage); break;
+            case EntityKind::BOSS: dungeon.spawn<BossEnemy>(room, name, record.damage); break;
+        }
+    }
+}
+
+bool compileDungeon(const std::string& source, std::string& binary, std::string& error) {
+    std::vector<SourceRoom> rooms;
+    std::vector<EntityRecord> entities;
+    StringPool strings;
+    std::unordered_map<std::string, std::uint32_t> roomIndex;
+
+    std::istringstream in(source);
+    std::string raw;
+    int lineNumber = 0;
+    while (std::getline(in, raw)) {
+        ++lineNumber;
+        std::string line = trim(raw);
+        if (line.empty() || line[0] == '#') continue;
+        size_t space = line.find_first_of(" \t");
+        std::string keyword = line.substr(0, space);
+        std::string value = space == std::string::npos ? "" : trim(line.substr(space));
+
+        if (keyword == "room") {
+            if (value.empty()) return failAt(lineNumber, "room needs a name", error);
+            if (!roomIndex.emplace(value, static_cast<std::uint32_t>(rooms.size())).second) {
+                return failAt(lineNumber, "duplicate room name: " + value, error);
+            }
+            rooms.emplace_back();
+            rooms.back().name = value;
+            rooms.back().line = lineNumber;
+            continue;
+        }
+        if (rooms.empty()) return failAt(lineNumber, "'" + keyword + "' before the first room", error);
+        SourceRoom& room = rooms.back();
+
+        EntityKind kind;
+        if (keyword == "description") room.description = value;
+        else if (keyword == "background") room.background = value;
+        else if (keyword == "choice") room.flags |= FLAG_CHOICE;
+        else if (keyword == "final_door") room.flags |= FLAG_FINAL_DOOR;
+        else if (keyword == "weapon_room") room.flags |= FLAG_WEAPON_ROOM;
+        else if (keyword == "detached") room.detached = true;
+        else if (keyword == "exit") room.exits.push_back({value, lineNumber});
+        else if (entityKindFor(keyword, kind)) {
+            if (room.entity != NO_ENTITY) return failAt(lineNumber, "a room holds one entity", error);
+            EntityRecord record = {static_cast<std::uint32_t>(kind), 0, 0};
+            std::string name = value;
+            if (kind == EntityKind::MINION || kind == EntityKind::BOSS) {
+                char* end = nullptr;
+                long damage = std::strtol(value.c_str(), &end, 10);
+                if (end == value.c_str() || damage < 0) return failAt(lineNumber, keyword + " needs <damage> <name>", error);
+                record.damage = static_cast<std::int32_t>(damage);
+                name = trim(end);
+            }
+            if (name.empty()) return failAt(lineNumber, keyword + " needs a name", error);
+            record.name = strings.add(name);
+            room.entity = static_cast<std::uint32_t>(entities.size());
+            entities.push_back(record);
+        }
+        else return failAt(lineNumber, "unknown directive: " + keyword, error);
+    }
+    if (rooms.empty()) { error = "no rooms defined"; return false; }
+
+    std::vector<RoomRecord> roomRecords;
+    std::vector<EdgeRecord> edges;
+    for (size_t i = 0; i < rooms.size(); ++i) {
+        const SourceRoom& room = rooms[i];
+        if (room.background.empty()) return failAt(room.line, "room '" + room.name + "' has no background", error);
+        roomRecords.push_back({strings.add(room.name), strings.add(room.description), strings.add(room.background), room.entity, room.flags});
+
+        std::uint32_t from = static_cast<std::uint32_t>(i);
+        if (i + 1 < rooms.size() && !rooms[i + 1].detached) edges.push_back({from, from + 1});
+        for (const SourceExit& exit : room.exits) {
+            auto target = roomIndex.find(exit.room);
+            if (target == roomIndex.end()) return failAt(exit.line, "unknown room: " + exit.room, error);
+            edges.push_back({from, target->second});
+        }
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.roomCount = static_cast<std::uint32_t>(roomRecords.size());
+    header.edgeCount = static_cast<std::uint32_t>(edges.size());
+    header.entityCount = static_cast<std::uint32_t>(entities.size());
+    header.stringCount = static_cast<std::uint32_t>(strings.strings.size());
+
+    binary.clear();
+    append(binary, header);
+    for (const RoomRecord& record : roomRecords) append(binary, record);
+    for (const EdgeRecord& record : edges) append(binary, record);
+    for (const EntityRecord& record : entities) append(binary, record);
+    std::uint32_t offset = 0;
+    for (const std::string& text : strings.strings) {
+        append(binary, offset);
+        offset += static_cast<std::uint32_t>(text.size());
+    }
+    append(binary, offset);
+    for (const std::string& text : strings.strings) binary += text;
+    return true;
+}
+
+bool loadDungeon(Dungeon& dungeon, const void* data, size_t size, std::string& error) {
+    const char* bytes = static_cast<const char*>(data);
+    if (dungeon.roomCount() != 0) { error = "dungeon already has rooms"; return false; }
+    if (size < sizeof(Header)) { error = "file too small"; return false; }
+    Header header = readRecord<Header>(bytes);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) { error = "not a compiled dungeon"; return false; }
+    if (header.version != VERSION) { error = "unsupported version " + std::to_string(header.version); return false; }
+    if (header.roomCount == 0) { error = "no rooms"; return false; }
+
+    const std::uint64_t roomsAt = sizeof(Header);
+    const std::uint64_t edgesAt = roomsAt + std::uint64_t(header.roomCount) * sizeof(RoomRecord);
+    const std::uint64_t entitiesAt = edgesAt + std::uint64_t(header.edgeCount) * sizeof(EdgeRecord);
+    const std::uint64_t offsetsAt = entitiesAt + std::uint64_t(header.entityCount) * sizeof(EntityRecord);
+    const std::uint64_t textAt = offsetsAt + (std::uint64_t(header.stringCount) + 1) * sizeof(std::uint32_t);
+    if (textAt > size) { error = "truncated records"; return false; }
+    const std::uint32_t textSize = readRecord<std::uint32_t>(bytes + textAt - sizeof(std::uint32_t));
+    if (textAt + textSize > size) { error = "truncated string table"; return false; }
+
+    // Validate every reference before touching the dungeon.
+    std::uint32_t previous = 0;
+    for (std::uint32_t i = 0; i <= header.stringCount; ++i) {
+        std::uint32_t offset = readRecord<std::uint32_t>(bytes + offsetsAt + i * sizeof(std::uint32_t));
+        if (offset < previous || offset > textSize) { error = "corrupt string table"; return false; }
+        previous = offset;
+    }
+    for (std::uint32_t i = 0; i < header.roomCount; ++i) {
+        RoomRecord room = readRecord<RoomRecord>(bytes + roomsAt + i * sizeof(RoomRecord));
+        bool valid = room.name < header.stringCount && room.description < header.stringCount && room.background < header.stringCount
+            && (room.entity == NO_ENTITY || room.entity < header.entityCount);
+        if (!valid) { error = "corrupt room " + std::to_string(i); return false; }
+    }
+    for (std::uint32_t i = 0; i < header.edgeCount; ++i) {
+        EdgeRecord edge = readRecord<EdgeRecord>(bytes + edgesAt + i * sizeof(EdgeRecord));
+        if (edge.from >= header.roomCount || edge.to >= header.roomCount) { error = "corrupt edge " + std::to_string(i); return false; }
+    }
+    std::vector<std::string> itemNames;
+    for (std::uint32_t i = 0; i < header.entityCount; ++i) {
+        EntityRecord entity = readRecord<EntityRecord>(bytes + entitiesAt + i * sizeof(EntityRecord));
+        if (entity.kind > static_cast<std::uint32_t>(EntityKind::BOSS) || entity.name >= header.stringCount) {
+            error = "corrupt entity " + std::to_string(i);
+            return false;
+        }
+        if (Item::matches(static_cast<EntityKind>(entity.kind))) {
+            std::uint32_t begin = readRecord<std::uint32_t>(bytes + offsetsAt + entity.name * sizeof(std::uint32_t));
+            std::uint32_t end = readRecord<std::uint32_t>(bytes + offsetsAt + (entity.name + 1) * sizeof(std::uint32_t));
+            itemNames.emplace_back(bytes + textAt + begin, end - begin);
+        }
+    }
+    // Items intern their names when spawned; registering them up front means
+    // running out of item kinds fails here instead of half-way through.
+    if (!ItemRegistry::internAll(itemNames)) {
+        error = "too many item kinds (at most " + std::to_string(ItemRegistry::MAX_ITEMS) + ")";
+        return false;
+    }
+
+    std::vector<StringId> text(header.stringCount);
+    for (std::uint32_t i = 0; i < header.stringCount; ++i) {
+        std::uint32_t begin = readRecord<std::uint32_t>(bytes + offsetsAt + i * sizeof(std::uint32_t));
+        std::uint32_t end = readRecord<std::uint32_t>(bytes + offsetsAt + (i + 1) * sizeof(std::uint32_t));
+        text[i] = dungeon.intern(std::string(bytes + textAt + begin, end - begin));
+    }
+
+    dungeon.reserve(header.roomCount, header.edgeCount);
+    for (std::uint32_t i = 0; i < header.roomCount; ++i) {
+        RoomRecord record = readRecord<RoomRecord>(bytes + roomsAt + i * sizeof(RoomRecord));
+        RoomId id = dungeon.addRoom(text[record.name], text[record.description], text[record.background], false);
+        Room& room = dungeon.getRoom(id);
+        room.isChoiceRoom = (record.flags & FLAG_CHOICE) != 0;
+        room.isFinalDoor = (record.flags & FLAG_FINAL_DOOR) != 0;
+        room.isWeaponRoom = (record.flags & FLAG_WEAPON_ROOM) != 0;
+        if (record.entity != NO_ENTITY) {
+            EntityRecord entity = readRecord<EntityRecord>(bytes + entitiesAt + record.entity * sizeof(EntityRecord));
+            spawnEntity(dungeon, id, entity, dungeon.text(text[entity.name]));
+        }
+    }
+    for (std::uint32_t i = 0; i < header.edgeCount; ++i) {
+        EdgeRecord edge = readRecord<EdgeRecord>(bytes + edgesAt + i * sizeof(EdgeRecord));
+        dungeon.addEdge(edge.from, edge.to);
+    }
+    return true;
+}
+
+bool loadDungeonFile(Dungeon& dungeon, const std::string& path, std::string& error) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) { error = "cannot open " + path; return false; }
+    std::vector<char> bytes(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    if (!in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()))) { error = "cannot read " + path; return false; }
+    return loadDungeon(dungeon, bytes.data(), bytes.size(), error);
+}
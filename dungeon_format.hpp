@@ -0,0 +1,85 @@
+#ifndef DUNGEON_FORMAT_HPP
+#define DUNGEON_FORMAT_HPP
+
+// =================================================================
+// DUNGEON DEFINITIONS
+// Levels are written as text (see levels/stock.dungeon) and compiled by
+// dungeonc into a binary the game loads in one read, or straight out of
+// the asset pack's mapping, with no text parsing at runtime.
+//
+// Text format, one directive per line, '#' starts a comment:
+//   room <name>              starts a room; it becomes exit 0 of the previous room
+//   description <text>
+//   background <texture file>
+//   minion <damage> <name>   | boss <damage> <name>
+//   weapon <name> | potion <name> | key <name> | item <name>
+//   choice                   the key-or-potion choice
+//   weapon_room              its weapon can be collected; no fleeing from it
+//   final_door
+//   detached                 not reachable from the previous room
+//   exit <room name>         an extra exit, after the default one
+//
+// Binary layout (little-endian, all fields 32-bit):
+//   Header
+//   RoomRecord[roomCount]
+//   EdgeRecord[edgeCount]     grouped by source room, exit order preserved
+//   EntityRecord[entityCount]
+//   uint32 stringOffsets[stringCount + 1]
+//   char   stringBytes[stringOffsets[stringCount]]
+// Text is deduplicated into the string table and referenced by index.
+// =================================================================
+
+#include "core.hpp"
+#include <cstdint>
+#include <string>
+
+namespace DungeonFormat {
+    const char MAGIC[4] = {'D', 'G', 'N', 'B'};
+    const std::uint32_t VERSION = 2;
+    const std::uint32_t NO_ENTITY = 0xFFFFFFFFu;
+
+    enum RoomFlags : std::uint32_t {
+        FLAG_CHOICE = 1u << 0,
+        FLAG_FINAL_DOOR = 1u << 1,
+        FLAG_WEAPON_ROOM = 1u << 2,
+    };
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t roomCount;
+        std::uint32_t edgeCount;
+        std::uint32_t entityCount;
+        std::uint32_t stringCount;
+    };
+
+    struct RoomRecord {
+        std::uint32_t name;
+        std::uint32_t description;
+        std::uint32_t background;
+        std::uint32_t entity; // Index into the entity records or NO_ENTITY.
+        std::uint32_t flags;
+    };
+
+    struct EdgeRecord {
+        std::uint32_t from;
+        std::uint32_t to;
+    };
+
+    struct EntityRecord {
+        std::uint32_t kind; // EntityKind
+        std::int32_t damage;
+        std::uint32_t name;
+    };
+}
+
+// Compiles a text definition into the binary format. On failure `error`
+// names the offending line.
+bool compileDungeon(const std::string& source, std::string& binary, std::string& error);
+
+// Loads a compiled definition into an empty Dungeon. Records are validated
+// before anything is added, so a bad file leaves the dungeon untouched.
+bool loadDungeon(Dungeon& dungeon, const void* data, size_t size, std::string& error);
+bool loadDungeonFile(Dungeon& dungeon, const std::string& path, std::string& error);
+
+#endif // DUNGEON_FORMAT_HPP
@@ -0,0 +1,48 @@
+#include "dungeon_format.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// =================================================================
+// DUNGEON COMPILER
+// Turns a text level definition into the binary the game loads.
+//   dungeonc <input.dungeon> <output.dgn>
+// =================================================================
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: dungeonc <input.dungeon> <output.dgn>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "Could not read: " << argv[1] << std::endl;
+        return 1;
+    }
+    std::stringstream source;
+    source << in.rdbuf();
+
+    std::string binary, error;
+    if (!compileDungeon(source.str(), binary, error)) {
+        std::cerr << argv[1] << ": " << error << std::endl;
+        return 1;
+    }
+
+    // Round-trip through the loader so a file that compiles is known to load.
+    Player probe("dungeonc", 100, 10);
+    Dungeon dungeon(probe);
+    if (!loadDungeon(dungeon, binary.data(), binary.size(), error)) {
+        std::cerr << argv[1] << ": compiled output does not load: " << error << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(argv[2], std::ios::binary);
+    if (!out || !out.write(binary.data(), static_cast<std::streamsize>(binary.size()))) {
+        std::cerr << "Could not write: " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cout << "Compiled " << dungeon.roomCount() << " rooms (" << binary.size() << " bytes) into " << argv[2] << std::endl;
+    return 0;
+}
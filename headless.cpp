@@ -0,0 +1,260 @@
+#include "core.hpp"
+#include "dungeon_format.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_set>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+// =================================================================
+// HEADLESS RUNNER
+// Plays the game through the core Action API with no window or assets.
+//   headless [--dungeon FILE.dgn] [runs] [seed]
+//                              randomized playthroughs, prints a summary
+//   headless [--dungeon FILE.dgn] --script KEYS
+//                              plays keys as the GUI would (F B C Q R 1 2 E=Enter)
+//   headless [--dungeon FILE.dgn] --search [MAX_STATES]
+//                              finds the shortest winning key script
+//   headless --generate MINIONS [seed]
+//                              builds a generated dungeon and walks it end to end
+// =================================================================
+
+namespace {
+    const int MAX_STEPS = 1000;
+
+    const char* const USAGE =
+        "Usage:\n"
+        "  headless [--dungeon FILE.dgn] [runs] [seed]\n"
+        "                             randomized playthroughs, prints a summary\n"
+        "  headless [--dungeon FILE.dgn] --script KEYS\n"
+        "                             plays keys as the GUI would (F B C Q R 1 2 E=Enter)\n"
+        "  headless [--dungeon FILE.dgn] --search [MAX_STATES]\n"
+        "                             finds the shortest winning key script\n"
+        "  headless --generate MINIONS [seed]\n"
+        "                             builds a generated dungeon and walks it end to end\n";
+
+    int usageError(const std::string& problem) {
+        std::cerr << problem << "\n" << USAGE;
+        return 1;
+    }
+
+    // Whole-string unsigned decimal; rejects empty strings, signs and trailing text.
+    bool parseCount(const char* text, unsigned long& value) {
+        if (!text || *text < '0' || *text > '9') return false;
+        char* end = nullptr;
+        value = std::strtoul(text, &end, 10);
+        return *end == '\0';
+    }
+
+    // Compiled level given with --dungeon; empty plays setupDungeon.
+    std::string levelBytes;
+
+    void buildLevel(Dungeon& dungeon) {
+        if (levelBytes.empty()) { setupDungeon(dungeon); return; }
+        std::string error;
+        if (!loadDungeon(dungeon, levelBytes.data(), levelBytes.size(), error)) std::cerr << "Could not load dungeon: " << error << std::endl;
+    }
+
+    bool readLevel(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream bytes;
+        bytes << in.rdbuf();
+        levelBytes = bytes.str();
+        Player probe("Headless", 100, 10);
+        Dungeon dungeon(probe);
+        std::string error;
+        if (in && loadDungeon(dungeon, levelBytes.data(), levelBytes.size(), error)) return true;
+        std::cerr << path << ": " << (in ? error : "cannot open") << std::endl;
+        return false;
+    }
+
+    int runScript(const std::string& keys) {
+        GameSession session("Headless", 100, 10);
+        buildLevel(session.getDungeon());
+        session.onLog = [](LogLine line, const std::string& arg) { std::cout << "- " << formatLogLine(line, arg) << std::endl; };
+        session.start();
+
+        for (char key : keys) {
+            if (session.isOver()) break;
+            Action action;
+            if (!actionForKey(session.getState(), key, action)) {
+                std::cerr << "Unknown key in script: " << key << std::endl;
+                return 1;
+            }
+            session.apply(action);
+        }
+
+        const Player& player = session.getPlayer();
+        std::cout << "Health: " << player.getHealth() << ", Moves: " << player.getMoves()
+                  << ", Inventory: " << player.getInventory().getSortedString() << std::endl;
+        std::cout << "Outcome: " << (session.isOver() ? outcomeReason(session.getOutcome()) : "In progress") << std::endl;
+        return session.getOutcome() == Outcome::VICTORY ? 0 : 2;
+    }
+
+    char keyForAction(Action action) {
+        switch (action) {
+            case Action::FORWARD: case Action::FIGHT: return 'F';
+            case Action::BACK: return 'B';
+            case Action::COLLECT: return 'C';
+            case Action::QUIT: return 'Q';
+            case Action::RUN: return 'R';
+            case Action::CHOOSE_KEY: return '1';
+            case Action::CHOOSE_POTION: return '2';
+            case Action::CONTINUE: return 'E';
+        }
+        return '?';
+    }
+
+    // Breadth-first search over game states. States are snapshots restored
+    // into one session, so branching never copies a Player or rebuilds the
+    // dungeon; identical snapshots are the same state and are expanded once.
+    int runSearch(size_t maxStates) {
+        struct Node {
+            std::string snapshot;
+            size_t parent;
+            char key;
+        };
+        GameSession session("Headless", 100, 10);
+        buildLevel(session.getDungeon());
+        session.start();
+
+        std::vector<Node> nodes(1);
+        session.saveSnapshot(nodes[0].snapshot);
+        std::unordered_set<std::string> seen{nodes[0].snapshot};
+        std::string child, error;
+        size_t winner = 0;
+        bool found = false;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t next = 0; next < nodes.size() && !found && nodes.size() < maxStates; ++next) {
+            bool restored = false;
+            for (Action action : ALL_ACTIONS) {
+                if (!restored && !session.restoreSnapshot(nodes[next].snapshot, error)) {
+                    std::cerr << "Could not restore a state: " << error << std::endl;
+                    return 1;
+                }
+                restored = true;
+                if (!session.canApply(action)) continue;
+                session.apply(action);
+                restored = false;
+                session.saveSnapshot(child);
+                if (!seen.insert(child).second) continue;
+                nodes.push_back({child, next, keyForAction(action)});
+                if (session.getOutcome() == Outcome::VICTORY) {
+                    winner = nodes.size() - 1;
+                    found = true;
+                    break;
+                }
+            }
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Explored " << nodes.size() << " states in " << ms << " ms" << std::endl;
+        if (!found) {
+            std::cout << "No winning script found" << std::endl;
+            return 2;
+        }
+        std::string keys;
+        for (size_t node = winner; node != 0; node = nodes[node].parent) keys += nodes[node].key;
+        std::cout << "Shortest win: " << std::string(keys.rbegin(), keys.rend()) << std::endl;
+        return 0;
+    }
+
+    // Stress test for the dungeon store: times generation and a full walk.
+    int runGenerate(int minions, unsigned int seed) {
+        std::mt19937 rng(seed);
+        Player walker("Headless", 100, minions + 10);
+        Dungeon dungeon(walker);
+
+        auto start = std::chrono::steady_clock::now();
+        generateDungeon(dungeon, rng, minions);
+        auto built = std::chrono::steady_clock::now();
+        size_t visited = 1;
+        while (dungeon.canMoveForward()) {
+            dungeon.moveForward();
+            ++visited;
+        }
+        auto walked = std::chrono::steady_clock::now();
+
+        std::cout << "Built " << dungeon.roomCount() << " rooms (" << dungeon.edgeCount() << " edges, "
+                  << dungeon.stringCount() << " strings) in "
+                  << std::chrono::duration<double, std::milli>(built - start).count() << " ms" << std::endl;
+        std::cout << "Walked " << visited << " rooms in "
+                  << std::chrono::duration<double, std::milli>(walked - built).count() << " ms" << std::endl;
+        return visited == dungeon.roomCount() ? 0 : 2;
+    }
+
+    int runRandom(long runs, unsigned int seed) {
+        std::mt19937 rng(seed);
+        std::map<Outcome, long> outcomes;
+        std::vector<Action> legal;
+
+        auto start = std::chrono::steady_clock::now();
+        for (long run = 0; run < runs; ++run) {
+            GameSession session("Headless", 100, 10);
+            buildLevel(session.getDungeon());
+            session.start();
+
+            for (int step = 0; step < MAX_STEPS && !session.isOver(); ++step) {
+                legal.clear();
+                for (Action action : ALL_ACTIONS) {
+                    if (session.canApply(action)) legal.push_back(action);
+                }
+                if (legal.empty()) break;
+                std::uniform_int_distribution<size_t> pick(0, legal.size() - 1);
+                session.apply(legal[pick(rng)]);
+            }
+            outcomes[session.getOutcome()]++;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << runs << " playthroughs in " << seconds << " s";
+        if (seconds > 0) std::cout << " (" << static_cast<long>(runs / seconds) << " / s)";
+        std::cout << std::endl;
+        for (const auto& entry : outcomes) {
+            const char* reason = entry.first == Outcome::NONE ? "Unfinished" : outcomeReason(entry.first);
+            std::cout << "  " << entry.second << "  " << reason << std::endl;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (!args.empty() && (args[0] == "--help" || args[0] == "-h")) {
+        std::cout << USAGE;
+        return 0;
+    }
+    if (!args.empty() && args[0] == "--dungeon") {
+        if (args.size() < 2) return usageError("--dungeon needs a file");
+        if (!readLevel(args[1])) return 1;
+        args.erase(args.begin(), args.begin() + 2);
+    }
+
+    unsigned long number = 0;
+    if (!args.empty() && args[0] == "--script") {
+        if (args.size() != 2) return usageError("--script needs one string of keys");
+        return runScript(args[1]);
+    }
+    if (!args.empty() && args[0] == "--search") {
+        if (args.size() > 2 || (args.size() == 2 && !parseCount(args[1].c_str(), number))) return usageError("--search takes an optional state count");
+        return runSearch(args.size() == 2 ? static_cast<size_t>(number) : 1000000);
+    }
+    if (!args.empty() && args[0] == "--generate") {
+        unsigned long seed = 0;
+        if (args.size() < 2 || args.size() > 3 || !parseCount(args[1].c_str(), number)
+            || (args.size() == 3 && !parseCount(args[2].c_str(), seed))) return usageError("--generate needs a minion count and an optional seed");
+        return runGenerate(static_cast<int>(number), args.size() == 3 ? static_cast<unsigned int>(seed) : std::random_device{}());
+    }
+
+    if (args.size() > 2) return usageError("Too many arguments");
+    unsigned long runs = 100000, seed = 0;
+    if (args.size() >= 1 && !parseCount(args[0].c_str(), runs)) return usageError("Unknown option or run count: " + args[0]);
+    if (args.size() == 2 && !parseCount(args[1].c_str(), seed)) return usageError("Not a seed: " + args[1]);
+    return runRandom(static_cast<long>(runs), args.size() == 2 ? static_cast<unsigned int>(seed) : std::random_device{}());
+}
@@ -11,26 +11,57 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
 #include <cmath>
+#include <cctype>
 #include <iomanip>
 #include <functional>
 #include <deque>
 #include <random>
-
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
 
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
-#if __cplusplus < 201402L
-// Provide make_unique for C++11
-namespace std {
-    template<typename T, typename... Args>
-    std::unique_ptr<T> make_unique(Args&&... args) {
-        return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
+#include "core.hpp"
+#include "asset_pack.hpp"
+#include "profiler.hpp"
+#include "audio.hpp"
+#include "dungeon_format.hpp"
+
+// --- Allocation Counting ---
+// Every heap allocation bumps the calling thread's allocationCounters(),
+// which the profiler turns into per-frame and per-phase counts. Build with
+// -DDUNGEON_NO_ALLOC_TRACKING to keep the standard operator new.
+#ifndef DUNGEON_NO_ALLOC_TRACKING
+namespace {
+    void* countedAllocate(std::size_t size) {
+        AllocationCounters& counters = allocationCounters();
+        counters.count++;
+        counters.bytes += size;
+        if (void* memory = std::malloc(size ? size : 1)) return memory;
+        throw std::bad_alloc();
     }
 }
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
 #endif
 
 // =================================================================
@@ -40,14 +71,36 @@ namespace std {
 namespace GameConfig {
     const unsigned int WINDOW_WIDTH = 1280;
     const unsigned int WINDOW_HEIGHT = 720;
-    const unsigned int FRAMERATE_LIMIT = 60;
+    const unsigned int FRAMERATE_LIMIT = 60; // Target for the LIMITED and PRECISE pacing modes.
+    const float FIXED_TIMESTEP = 1.f / 120.f;
+    const int MAX_STEPS_PER_FRAME = 10; // Beyond this the simulation slows down rather than spiralling.
+    const float MAX_FRAME_TIME = 0.25f;
+    const float PRECISE_PACING_SPIN = 0.002f; // PRECISE sleeps until this close to the deadline, then yields.
+    const float IDLE_POLL_INTERVAL = 0.03f;    // Power saving: input poll period while nothing changes on screen.
+    const float BACKGROUND_TICK_RATE = 15.f;   // Power saving: loop rate while unfocused (keeps sim at real time).
     const std::string FONT_PATH_ARIBLK = "ariblk.ttf";
     const std::string MENU_BG_PATH_PREFIX = "assets/"; // MODIFIED: Path prefix for assets
+    const std::string ASSET_PACK_PATH = "assets.pak";
+    const std::string DUNGEON_PATH = "assets/stock.dgn"; // Compiled from levels/stock.dungeon; setupDungeon() if absent.
     const int MENU_BG_FRAME_COUNT = 20;
     const float BG_ANIMATION_DELAY = 0.08f;
+    const float CURSOR_BLINK_INTERVAL = 0.5f;
     const float TRANSITION_DURATION = 0.7f;
     const float GAMEPLAY_TRANSITION_DURATION = 0.4f;
     const unsigned int MAX_NAME_LENGTH = 15;
+    const unsigned int MAX_LOADER_THREADS = 4;
+    const size_t TEXTURE_UPLOADS_PER_FRAME = 2;
+    const size_t TEXTURE_BUDGET_BYTES = 48 * 1024 * 1024; // Room backgrounds; menu atlas and fonts are not counted.
+    const bool BACKGROUND_SMOOTH = true;   // Filter pre-scaled backgrounds.
+    const bool BACKGROUND_MIPMAPS = true;  // Prefilter sources shrunk by half or more.
+    const size_t BACKGROUND_CACHE_ENTRIES = 4; // Pre-scaled backgrounds kept.
+    const bool POST_PROCESS_SHADER = true; // Fades, flash and shake in one shader pass when supported.
+    const float DAMAGE_VIGNETTE = 0.6f;    // Edge darkening at the flash's peak (shader pass only).
+    const std::string PROFILE_CAPTURE_NAME = "frame_profile"; // F4 writes frame_profile.csv / .json
+    const float PROFILER_OVERLAY_REFRESH = 0.25f;
+    const std::string SAVE_PATH = "savegame.dat"; // F6 saves, F9 loads.
+    const float MUSIC_VOLUME = 50.f;
+    const float MUSIC_CROSSFADE = 1.5f;
 
     // --- Color Palette ---
     const sf::Color GOLD_COLOR = sf::Color(255, 215, 0);
@@ -58,13 +111,21 @@ namespace GameConfig {
     const sf::Color LOG_BLUE_COLOR = sf::Color(173, 216, 230);
 }
 
+// --- Frame Pacing ---
+// LIMITED: SFML's framerate limit. VSYNC: the driver's vertical sync.
+// PRECISE: sleeps most of the frame, then yields up to the deadline.
+// UNCAPPED: renders as fast as possible, for benchmarking.
+enum class PacingMode { LIMITED, VSYNC, PRECISE, UNCAPPED };
+
 // --- Game State Identifiers ---
 enum class GameStateID {
     NONE,
+    LOADING,
     MENU,
     NAME_INPUT,
     GAMEPLAY,
-    GAME_OVER
+    GAME_OVER,
+    COUNT
 };
 
 // --- Transition States ---
@@ -74,493 +135,1902 @@ enum class TransitionState {
     FADING_IN
 };
 
+// Game logic (section 1) lives in core.hpp / core.cpp.
+
 
 // =================================================================
-// 1. GAME LOGIC 
+// 2. GUI FRAMEWORK & SCREENS
 // =================================================================
+class Game;
+
+// --- Text Layout ---
+// Word-wraps strings in a single linear pass using cached per-font glyph
+// advances and kerning, instead of re-measuring a temporary sf::Text per word.
+// Finished layouts are cached per font settings (font, character size,
+// style, outline), string and wrap width, so texts wrapping the same string
+// at different widths keep separate entries.
+class TextLayout {
+private:
+    static const size_t MAX_CACHED_LAYOUTS = 256;
+
+    struct CachedLayout {
+        float maxWidth;
+        std::string wrapped;
+    };
+
+    struct FontMetrics {
+        const sf::Font* font;
+        unsigned int size;
+        bool bold;
+        float outline;
+        float spaceAdvance;
+        float asciiAdvances[128];
+        std::unordered_map<sf::Uint32, float> extendedAdvances;
+        std::unordered_map<sf::Uint64, float> kerning;
+        // Keyed by string, then a short list of the widths it was wrapped at;
+        // lookups compare against `source` without building a key.
+        std::unordered_map<std::string, std::vector<CachedLayout>> layouts;
+        size_t layoutCount = 0;
+
+        FontMetrics(const sf::Font* f, unsigned int s, bool b, float o) : font(f), size(s), bold(b), outline(o) {
+            std::fill(asciiAdvances, asciiAdvances + 128, -1.f);
+            spaceAdvance = advance(' ');
+        }
+
+        float advance(sf::Uint32 c) {
+            if (c < 128) {
+                if (asciiAdvances[c] < 0.f) asciiAdvances[c] = font->getGlyph(c, size, bold).advance;
+                return asciiAdvances[c];
+            }
+            auto it = extendedAdvances.find(c);
+            if (it != extendedAdvances.end()) return it->second;
+            float value = font->getGlyph(c, size, bold).advance;
+            extendedAdvances[c] = value;
+            return value;
+        }
+
+        float kern(sf::Uint32 first, sf::Uint32 second) {
+            sf::Uint64 key = (static_cast<sf::Uint64>(first) << 32) | second;
+            auto it = kerning.find(key);
+            if (it != kerning.end()) return it->second;
+            float value = font->getKerning(first, second, size);
+            kerning[key] = value;
+            return value;
+        }
+    };
 
-class Player;
-class Dungeon;
+    typedef std::pair<std::pair<const sf::Font*, unsigned int>, std::pair<bool, float>> MetricsKey;
+    static std::map<MetricsKey, std::unique_ptr<FontMetrics>> metrics;
+
+    static FontMetrics& getMetrics(const sf::Font& font, unsigned int size, bool bold, float outline) {
+        MetricsKey key{{&font, size}, {bold, outline}};
+        auto it = metrics.find(key);
+        if (it == metrics.end()) {
+            it = metrics.emplace(key, std::unique_ptr<FontMetrics>(new FontMetrics(&font, size, bold, outline))).first;
+        }
+        return *it->second;
+    }
+
+    static void layout(FontMetrics& m, const std::string& source, float maxWidth, std::string& out) {
+        out.clear();
+        out.reserve(source.size());
+        // Outlines widen the rendered bounds on both sides of every line.
+        float limit = maxWidth - 2.f * m.outline;
+        float lineWidth = 0.f;
+        sf::Uint32 lineLast = 0;
+        bool lineEmpty = true;
+
+        size_t i = 0, n = source.size();
+        while (i < n) {
+            while (i < n && std::isspace(static_cast<unsigned char>(source[i]))) ++i;
+            if (i >= n) break;
+            size_t start = i;
+
+            float wordWidth = 0.f;
+            sf::Uint32 prev = 0;
+            while (i < n && !std::isspace(static_cast<unsigned char>(source[i]))) {
+                sf::Uint32 c = static_cast<unsigned char>(source[i]);
+                if (i > start) wordWidth += m.kern(prev, c);
+                wordWidth += m.advance(c);
+                prev = c;
+                ++i;
+            }
+            sf::Uint32 wordFirst = static_cast<unsigned char>(source[start]);
+
+            if (!lineEmpty) {
+                float joined = lineWidth + m.kern(lineLast, ' ') + m.spaceAdvance + m.kern(' ', wordFirst) + wordWidth;
+                if (joined > limit) {
+                    out += '\n';
+                    lineWidth = wordWidth;
+                } else {
+                    out += ' ';
+                    lineWidth = joined;
+                }
+            } else {
+                lineWidth = wordWidth;
+            }
+            out.append(source, start, i - start);
+            lineLast = prev;
+            lineEmpty = false;
+        }
+    }
 
-class Entity {
 public:
-    virtual ~Entity() = default;
-    virtual std::string getDescription() const = 0;
-    virtual void interact(Player& player, std::string& interactionResult) = 0;
-    virtual std::string getName() const = 0;
+    // Returns the wrapped form of `source` as it would render with `text`'s font settings.
+    // The reference stays valid until the next call.
+    static const std::string& wrap(const sf::Text& text, const std::string& source, float maxWidth) {
+        static const std::string empty;
+        const sf::Font* font = text.getFont();
+        if (!font || source.empty()) return source.empty() ? empty : source;
+
+        FontMetrics& m = getMetrics(*font, text.getCharacterSize(), (text.getStyle() & sf::Text::Bold) != 0, text.getOutlineThickness());
+        auto it = m.layouts.find(source);
+        if (it != m.layouts.end()) {
+            for (const CachedLayout& cached : it->second) {
+                if (cached.maxWidth == maxWidth) return cached.wrapped;
+            }
+        }
+
+        if (m.layoutCount >= MAX_CACHED_LAYOUTS) {
+            m.layouts.clear();
+            m.layoutCount = 0;
+            it = m.layouts.end();
+        }
+        std::vector<CachedLayout>& widths = it != m.layouts.end() ? it->second : m.layouts[source];
+        widths.push_back({maxWidth, std::string()});
+        ++m.layoutCount;
+        layout(m, source, maxWidth, widths.back().wrapped);
+        return widths.back().wrapped;
+    }
+
+    // Sets `text` to the wrapped form of `source`.
+    static void setWrappedString(sf::Text& text, const std::string& source, float maxWidth) {
+        text.setString(wrap(text, source, maxWidth));
+    }
 };
+std::map<TextLayout::MetricsKey, std::unique_ptr<TextLayout::FontMetrics>> TextLayout::metrics;
+
+// --- Text Batch ---
+// Draws a layer of sf::Text objects with one draw call per glyph page,
+// where each sf::Text costs two (outline, then fill). SFML keeps a glyph
+// page per font and character size, so texts of the same font and size
+// share a call; a page's outlines go ahead of its fills in one vertex
+// array, since both are rasterized onto that page. Glyph quads are laid
+// out as sf::Text does for regular and bold text, and rebuilt only after
+// invalidate(). Texts stay owned by the caller and are never drawn.
+class TextBatch {
+private:
+    struct Page {
+        const sf::Font* font;
+        unsigned int size;
+        std::vector<sf::Vertex> outlines;
+        std::vector<sf::Vertex> vertices; // Outlines, then fills.
+    };
+
+    std::vector<const sf::Text*> texts;
+    std::vector<Page> pages;
+    bool dirty = true;
+
+    Page& pageFor(const sf::Font* font, unsigned int size) {
+        for (Page& page : pages) {
+            if (page.font == font && page.size == size) return page;
+        }
+        pages.push_back({font, size, {}, {}});
+        return pages.back();
+    }
+
+    static void addGlyphQuad(std::vector<sf::Vertex>& out, const sf::Transform& transform, sf::Vector2f position,
+                             const sf::Color& color, const sf::Glyph& glyph, float outline) {
+        const float padding = 1.f;
+        float left = glyph.bounds.left - padding - outline;
+        float top = glyph.bounds.top - padding - outline;
+        float right = glyph.bounds.left + glyph.bounds.width + padding - outline;
+        float bottom = glyph.bounds.top + glyph.bounds.height + padding - outline;
+        float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+        float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+        float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+        float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+        auto corner = [&](float x, float y, float u, float v) {
+            out.push_back(sf::Vertex(transform.transformPoint(sf::Vector2f(position.x + x, position.y + y)), color, sf::Vector2f(u, v)));
+        };
+        corner(left, top, u1, v1);
+        corner(right, top, u2, v1);
+        corner(left, bottom, u1, v2);
+        corner(left, bottom, u1, v2);
+        corner(right, top, u2, v1);
+        corner(right, bottom, u2, v2);
+    }
+
+    void append(const sf::Text& text) {
+        const sf::Font* font = text.getFont();
+        const sf::String& string = text.getString();
+        if (!font || string.isEmpty()) return;
+
+        unsigned int size = text.getCharacterSize();
+        bool bold = (text.getStyle() & sf::Text::Bold) != 0;
+        float outline = text.getOutlineThickness();
+        const sf::Transform& transform = text.getTransform();
+        Page& page = pageFor(font, size);
+
+        float whitespace = font->getGlyph(' ', size, bold).advance;
+        float letterSpacing = (whitespace / 3.f) * (text.getLetterSpacing() - 1.f);
+        whitespace += letterSpacing;
+        float lineSpacing = font->getLineSpacing(size) * text.getLineSpacing();
+        float x = 0.f;
+        float y = static_cast<float>(size);
+        sf::Uint32 previous = 0;
+        for (std::size_t i = 0; i < string.getSize(); ++i) {
+            sf::Uint32 c = string[i];
+            if (c == '\r') continue;
+            x += font->getKerning(previous, c, size);
+            previous = c;
+            if (c == ' ') { x += whitespace; continue; }
+            if (c == '\t') { x += whitespace * 4.f; continue; }
+            if (c == '\n') { y += lineSpacing; x = 0.f; continue; }
+
+            if (outline != 0.f) addGlyphQuad(page.outlines, transform, {x, y}, text.getOutlineColor(), font->getGlyph(c, size, bold, outline), outline);
+            const sf::Glyph& glyph = font->getGlyph(c, size, bold);
+            addGlyphQuad(page.vertices, transform, {x, y}, text.getFillColor(), glyph, 0.f);
+            x += glyph.advance + letterSpacing;
+        }
+    }
+
+    void rebuild() {
+        for (Page& page : pages) {
+            page.outlines.clear();
+            page.vertices.clear();
+        }
+        for (const sf::Text* text : texts) append(*text);
+        for (Page& page : pages) page.vertices.insert(page.vertices.begin(), page.outlines.begin(), page.outlines.end());
+        dirty = false;
+    }
 
-class Item : public Entity {
-protected:
-    std::string name;
 public:
-    explicit Item(std::string n) : name(std::move(n)) {}
-    std::string getName() const override { return name; }
-    void interact(Player& player, std::string& interactionResult) override;
-    std::string getDescription() const override { return "You see a " + name + "."; }
+    // Texts are drawn in the order added, grouped by page.
+    void add(const sf::Text& text) { texts.push_back(&text); dirty = true; }
+    // Call after changing any text's string, style or transform.
+    void invalidate() { dirty = true; }
+
+    void draw(sf::RenderTarget& target) {
+        if (dirty) rebuild();
+        for (const Page& page : pages) {
+            if (page.vertices.empty()) continue;
+            // Fetched at draw time: adding glyphs can grow the page texture.
+            sf::RenderStates states(&page.font->getTexture(page.size));
+            target.draw(page.vertices.data(), page.vertices.size(), sf::Triangles, states);
+        }
+    }
 };
 
-class Weapon : public Item {
+// --- Layer Cache ---
+// Holds a screen's static layer (background, panels, settled text) in a
+// render texture. The layer is composed again only after invalidate() or
+// when the window's pixel size changes; otherwise a frame costs one
+// textured quad, and screens draw just their dynamic overlays on top. The
+// texture matches the viewport's pixels, so the cache is as sharp as
+// drawing directly. The layer starts transparent and is blended on with
+// premultiplied alpha, so it can also sit over content drawn each frame
+// beneath it. Without render-texture support the layer is simply composed
+// straight into the window every frame.
+class LayerCache {
+private:
+    sf::RenderTexture texture;
+    sf::Sprite sprite;
+    sf::Vector2u pixelSize;
+    bool available = false;
+    bool dirty = true;
+
 public:
-    explicit Weapon(std::string n) : Item(std::move(n)) {}
-    std::string getDescription() const override { return "A powerful " + name + " rests here."; }
+    void invalidate() { dirty = true; }
+
+    // `compose` draws the layer in logical (GameConfig) coordinates onto the
+    // sf::RenderTarget it is given.
+    template <typename Compose>
+    void draw(sf::RenderTarget& window, Compose compose) {
+        sf::IntRect viewport = window.getViewport(window.getView());
+        sf::Vector2u wanted(static_cast<unsigned int>(std::max(1, viewport.width)), static_cast<unsigned int>(std::max(1, viewport.height)));
+        if (wanted != pixelSize) {
+            pixelSize = wanted;
+            available = texture.create(wanted.x, wanted.y);
+            if (available) sprite.setTexture(texture.getTexture(), true);
+            dirty = true;
+        }
+        if (!available) {
+            compose(window);
+            return;
+        }
+
+        sf::Vector2f logical(static_cast<float>(GameConfig::WINDOW_WIDTH), static_cast<float>(GameConfig::WINDOW_HEIGHT));
+        if (dirty) {
+            PROFILE_SCOPE("layer.compose");
+            texture.setView(sf::View(sf::FloatRect(0.f, 0.f, logical.x, logical.y)));
+            texture.clear(sf::Color::Transparent);
+            compose(texture);
+            texture.display();
+            dirty = false;
+        }
+        sprite.setScale(logical.x / pixelSize.x, logical.y / pixelSize.y);
+        // Composing with ordinary alpha blending leaves premultiplied colour.
+        window.draw(sprite, sf::RenderStates(sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha)));
+    }
 };
 
-class Potion : public Item {
-public:
-    explicit Potion(std::string n) : Item(std::move(n)) {}
-    std::string getDescription() const override { return "A bubbling " + name + " is on a pedestal.";}
+// --- Post Process ---
+// Full-screen effects for a frame: fade to black, flash tint, vignette and
+// shake. Screens add theirs in Screen::addEffects().
+struct PostEffects {
+    float fade = 0.f;                          // Black over the scene, 0..1.
+    sf::Color flash = sf::Color::Transparent;  // Tint; alpha is its strength.
+    float vignette = 0.f;                      // Edge darkening, 0..1.
+    sf::Vector2f shake;                        // Scene offset in logical pixels.
+
+    // Stacks another fade as a second black overlay would.
+    void addFade(float amount) { fade = 1.f - (1.f - fade) * (1.f - amount); }
+    bool any() const { return fade > 0.f || flash.a > 0 || vignette > 0.f || shake != sf::Vector2f(); }
 };
 
-class Key : public Item {
+// Applies PostEffects in one pass. With shader support, while any effect is
+// active the scene is drawn into a render texture the size of the
+// viewport's pixels and then onto the window by a single fragment shader;
+// otherwise it goes straight to the window. Without shaders the view is
+// shifted for shake and fade and flash are drawn as translucent rectangles
+// over the scene; the vignette is skipped.
+class PostProcess {
+private:
+    sf::RenderTexture scene;
+    sf::Sprite sprite;
+    sf::Shader shader;
+    sf::RectangleShape overlay;
+    sf::Vector2u pixelSize;
+    bool shaderReady = false;
+    bool sceneReady = false;
+    bool intoScene = false; // This frame draws into `scene`.
+    PostEffects effects;
+    sf::View view;
+
+    static const char* fragmentSource() {
+        return
+            "uniform sampler2D scene;\n"
+            "uniform vec2 offset;\n"
+            "uniform float fade;\n"
+            "uniform vec4 flash;\n"
+            "uniform float vignette;\n"
+            "void main() {\n"
+            "    vec2 uv = gl_TexCoord[0].xy + offset;\n"
+            "    vec3 color = texture2D(scene, uv).rgb;\n"
+            "    if (uv.x < 0.0 || uv.x > 1.0 || uv.y < 0.0 || uv.y > 1.0) color = vec3(0.0);\n"
+            "    color = mix(color, flash.rgb, flash.a);\n"
+            "    color *= 1.0 - vignette * smoothstep(0.3, 0.75, length(gl_TexCoord[0].xy - 0.5));\n"
+            "    gl_FragColor = vec4(color * (1.0 - fade), 1.0);\n"
+            "}\n";
+    }
+
 public:
-    explicit Key(std::string n) : Item(std::move(n)) {}
-    std::string getDescription() const override { return "A shiny " + name + " catches your eye.";}
+    PostProcess() {
+        overlay.setSize({static_cast<float>(GameConfig::WINDOW_WIDTH), static_cast<float>(GameConfig::WINDOW_HEIGHT)});
+    }
+
+    // Compiles the shader; the rectangle fallback is used if that fails.
+    void init(bool useShader) {
+        shaderReady = false;
+        if (!useShader) return;
+        if (!sf::Shader::isAvailable()) {
+            std::cerr << "Shaders unavailable; drawing effects without them." << std::endl;
+            return;
+        }
+        shaderReady = shader.loadFromMemory(fragmentSource(), sf::Shader::Fragment);
+        if (!shaderReady) std::cerr << "Post-process shader failed to compile; drawing effects without it." << std::endl;
+    }
+    bool usesShader() const { return shaderReady; }
+
+    // Returns where the scene should be drawn this frame, with `sceneView`
+    // set on it. Call end() once the scene is drawn.
+    sf::RenderTarget& begin(sf::RenderWindow& window, const sf::View& sceneView, const PostEffects& frameEffects) {
+        effects = frameEffects;
+        view = sceneView;
+        intoScene = false;
+        if (shaderReady && effects.any()) {
+            sf::IntRect viewport = window.getViewport(view);
+            sf::Vector2u wanted(static_cast<unsigned int>(std::max(1, viewport.width)), static_cast<unsigned int>(std::max(1, viewport.height)));
+            if (wanted != pixelSize) {
+                pixelSize = wanted;
+                sceneReady = scene.create(wanted.x, wanted.y);
+                if (sceneReady) sprite.setTexture(scene.getTexture(), true);
+            }
+            intoScene = sceneReady;
+        }
+        if (intoScene) {
+            scene.setView(sf::View(sf::FloatRect(0.f, 0.f, static_cast<float>(GameConfig::WINDOW_WIDTH), static_cast<float>(GameConfig::WINDOW_HEIGHT))));
+            scene.clear(sf::Color::Black);
+            return scene;
+        }
+        sf::View shaken = view;
+        shaken.move(effects.shake.x, effects.shake.y);
+        window.setView(shaken);
+        return window;
+    }
+
+    void end(sf::RenderWindow& window) {
+        window.setView(view);
+        sf::Vector2f logical(static_cast<float>(GameConfig::WINDOW_WIDTH), static_cast<float>(GameConfig::WINDOW_HEIGHT));
+        if (intoScene) {
+            scene.display();
+            shader.setUniform("scene", sf::Shader::CurrentTexture);
+            shader.setUniform("offset", sf::Glsl::Vec2(effects.shake.x / logical.x, effects.shake.y / logical.y));
+            shader.setUniform("fade", effects.fade);
+            shader.setUniform("flash", sf::Glsl::Vec4(effects.flash));
+            shader.setUniform("vignette", effects.vignette);
+            sprite.setScale(logical.x / pixelSize.x, logical.y / pixelSize.y);
+            window.draw(sprite, &shader);
+            return;
+        }
+        if (effects.flash.a > 0) {
+            overlay.setFillColor(effects.flash);
+            window.draw(overlay);
+        }
+        if (effects.fade > 0.f) {
+            overlay.setFillColor(sf::Color(0, 0, 0, static_cast<sf::Uint8>(effects.fade * 255.f)));
+            window.draw(overlay);
+        }
+    }
 };
 
-class Enemy : public Entity {
-protected:
-    std::string name;
-    int damage;
+namespace Utils {
+    void centerOrigin(sf::Text& text) {
+        sf::FloatRect bounds = text.getLocalBounds();
+        text.setOrigin(bounds.left + bounds.width / 2.0f, bounds.top + bounds.height / 2.0f);
+    }
+
+    void centerOrigin(sf::Sprite& sprite) {
+        sf::FloatRect bounds = sprite.getLocalBounds();
+        sprite.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
+    }
+
+    void centerOrigin(sf::RectangleShape& rect) {
+        sf::Vector2f size = rect.getSize();
+        rect.setOrigin(size.x / 2.0f, size.y / 2.0f);
+    }
+
+    void wrapText(sf::Text& text, float maxWidth) {
+        std::string string = text.getString();
+        if (string.empty()) return;
+        TextLayout::setWrappedString(text, string, maxWidth);
+    }
+
+    float lerp(float a, float b, float t) { return a + t * (b - a); }
+    float clamp(float value, float min, float max) { return std::max(min, std::min(value, max)); }
+}
+
+// --- Frame Arena ---
+// Bump allocator for text and buffers that live for one frame, reset at the
+// top of every frame. The storage is static, so transient strings built in
+// it cost no heap allocation; a request that does not fit returns nullptr.
+class FrameArena {
 public:
-    Enemy(std::string n, int d) : name(std::move(n)), damage(d) {}
-    std::string getName() const override { return name; }
-    int getDamage() const { return damage; }
-    std::string getDescription() const override { return "DANGER! A " + name + " blocks your path."; }
-    void interact(Player& player, std::string& interactionResult) override;
+    static const size_t CAPACITY = 64 * 1024;
+private:
+    static char storage[CAPACITY];
+    static size_t used;
+    static size_t highWater;
+public:
+    static void reset() { used = 0; }
+    static char* allocate(size_t bytes) {
+        size_t start = (used + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        if (start + bytes > CAPACITY) return nullptr;
+        used = start + bytes;
+        if (used > highWater) highWater = used;
+        return storage + start;
+    }
+    static size_t getHighWater() { return highWater; }
 };
+char FrameArena::storage[FrameArena::CAPACITY];
+size_t FrameArena::used = 0;
+size_t FrameArena::highWater = 0;
 
-class MinionEnemy : public Enemy {
+// A string assembled in the frame arena, valid until the next reset.
+// Appends past `capacity` are cut off.
+class FrameString {
+private:
+    char* data;
+    size_t length = 0;
+    size_t capacity;
 public:
-    MinionEnemy(std::string n, int d) : Enemy(std::move(n), d) {}
+    explicit FrameString(size_t capacityBytes) {
+        data = FrameArena::allocate(capacityBytes + 1);
+        capacity = data ? capacityBytes : 0;
+        static char empty = '\0';
+        if (!data) data = &empty;
+        data[0] = '\0';
+    }
+
+    FrameString& append(const char* text, size_t count) {
+        size_t n = std::min(count, capacity - length);
+        std::memcpy(data + length, text, n);
+        length += n;
+        data[length] = '\0';
+        return *this;
+    }
+    FrameString& operator<<(const char* text) { return append(text, std::strlen(text)); }
+    FrameString& operator<<(const std::string& text) { return append(text.data(), text.size()); }
+    FrameString& operator<<(int value) {
+        char digits[16];
+        int n = std::snprintf(digits, sizeof(digits), "%d", value);
+        return append(digits, n > 0 ? static_cast<size_t>(n) : 0);
+    }
+
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    const char* c_str() const { return data; }
 };
 
-class BossEnemy : public Enemy {
+// --- Simulation Clock ---
+// Game time, advanced only by the fixed update step. Every timed effect (see
+// TweenSystem) reads it instead of the wall clock, so a hitch never
+// stretches a step and updates are deterministic. The
+// render lead is the part of a step the loop has not simulated yet; draw
+// code adds it to interpolate between the last step and the next.
+class SimClock {
+private:
+    static sf::Time now;
+    static sf::Time renderLead;
 public:
-    BossEnemy(std::string n, int d) : Enemy(std::move(n), d) {}
-    void interact(Player& player, std::string& interactionResult) override;
+    static sf::Time getTime() { return now; }
+    static sf::Time getRenderLead() { return renderLead; }
+    static void advance(sf::Time step) { now += step; }
+    static void setRenderLead(sf::Time lead) { renderLead = lead; }
 };
+sf::Time SimClock::now;
+sf::Time SimClock::renderLead;
+
+// --- Tweens ---
+// Every timed effect (fades, flash, shake, cursor blink, background frames)
+// is a tween: a float eased between two values over a duration, optionally
+// written to a target, optionally looping, with a completion callback.
+//   handle = tweens.start({180.f, 0.f, 0.25f});
+//   float alpha = tweens.sample(handle, 0.f);
+// Active tweens are packed into parallel arrays and advanced in one pass per
+// fixed step from the SimClock; with none active, update() returns at once.
+// A callback is a function pointer plus context, so starting a tween does not
+// allocate once the arrays have grown. Handles carry a generation: a handle
+// whose tween finished or was cancelled is simply inactive. Owners must
+// cancel tweens that point into them before they are destroyed.
+enum class Ease : std::uint8_t { LINEAR, IN_QUAD, OUT_QUAD, IN_OUT_QUAD };
+
+class TweenSystem {
+public:
+    typedef void (*Callback)(void* context, int arg);
+    enum : std::uint32_t { NO_SLOT = 0xFFFFFFFFu };
+
+    struct Handle {
+        std::uint32_t slot = NO_SLOT;
+        std::uint32_t generation = 0;
+    };
+
+    struct Tween {
+        float from;
+        float to;
+        float duration; // Seconds.
+        Ease ease = Ease::LINEAR;
+        bool loop = false; // Restart on completion; the callback runs every cycle.
+        float* target = nullptr; // Written with the value every step, if set.
+        Callback onComplete = nullptr;
+        void* context = nullptr;
+        int arg = 0;
+    };
 
-template <typename T>
-class Stack {
 private:
-    struct Node {
-        T data;
-        Node* next;
-        Node(T d, Node* n) : data(d), next(n) {}
+    // Active tweens, densely packed.
+    std::vector<sf::Int64> startUs;
+    std::vector<sf::Int64> durationUs;
+    std::vector<float> from;
+    std::vector<float> to;
+    std::vector<Ease> ease;
+    std::vector<std::uint8_t> looping;
+    std::vector<float*> target;
+    std::vector<Callback> callback;
+    std::vector<void*> context;
+    std::vector<int> arg;
+    std::vector<std::uint32_t> slotOf;
+    // Handle slots: dense index (or NO_SLOT) and generation.
+    std::vector<std::uint32_t> denseOf;
+    std::vector<std::uint32_t> generations;
+    std::vector<std::uint32_t> freeSlots;
+
+    struct Completion {
+        Callback callback;
+        void* context;
+        int arg;
     };
-    Node* topNode = nullptr;
-    size_t count = 0;
+    std::vector<Completion> completed;
+
+    static float applyEase(Ease e, float t) {
+        switch (e) {
+            case Ease::IN_QUAD: return t * t;
+            case Ease::OUT_QUAD: return t * (2.f - t);
+            case Ease::IN_OUT_QUAD: return t < 0.5f ? 2.f * t * t : -1.f + (4.f - 2.f * t) * t;
+            default: return t;
+        }
+    }
+
+    float valueAt(size_t i, sf::Int64 nowUs) const {
+        float t = durationUs[i] > 0 ? static_cast<float>(nowUs - startUs[i]) / durationUs[i] : 1.f;
+        t = t < 0.f ? 0.f : (t > 1.f ? 1.f : t);
+        return from[i] + (to[i] - from[i]) * applyEase(ease[i], t);
+    }
+
+    std::uint32_t denseIndex(Handle handle) const {
+        if (handle.slot >= denseOf.size() || generations[handle.slot] != handle.generation) return NO_SLOT;
+        return denseOf[handle.slot];
+    }
+
+    template <typename T>
+    static void swapRemove(std::vector<T>& values, size_t i) {
+        values[i] = values.back();
+        values.pop_back();
+    }
+
+    void remove(size_t i) {
+        std::uint32_t slot = slotOf[i];
+        size_t last = startUs.size() - 1;
+        if (i != last) denseOf[slotOf[last]] = static_cast<std::uint32_t>(i);
+        swapRemove(startUs, i);
+        swapRemove(durationUs, i);
+        swapRemove(from, i);
+        swapRemove(to, i);
+        swapRemove(ease, i);
+        swapRemove(looping, i);
+        swapRemove(target, i);
+        swapRemove(callback, i);
+        swapRemove(context, i);
+        swapRemove(arg, i);
+        swapRemove(slotOf, i);
+        denseOf[slot] = NO_SLOT;
+        generations[slot]++;
+        freeSlots.push_back(slot);
+    }
+
 public:
-    ~Stack() { while (!isEmpty()) pop(); }
-    Stack(const Stack&) = delete;
-    Stack& operator=(const Stack&) = delete;
-    Stack(Stack&&) = delete;
-    Stack& operator=(Stack&&) = delete;
-    Stack() = default;
-
-    void push(const T& value) { topNode = new Node(value, topNode); count++; }
-    void pop() {
-        if (isEmpty()) return;
-        Node* temp = topNode;
-        topNode = topNode->next;
-        delete temp;
-        count--;
-    }
-    T& top() const { if (isEmpty()) throw std::runtime_error("Stack is empty."); return topNode->data; }
-    bool isEmpty() const { return topNode == nullptr; }
-    size_t size() const { return count; }
+    Handle start(const Tween& tween) {
+        std::uint32_t slot;
+        if (freeSlots.empty()) {
+            slot = static_cast<std::uint32_t>(denseOf.size());
+            denseOf.push_back(NO_SLOT);
+            generations.push_back(0);
+        } else {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        denseOf[slot] = static_cast<std::uint32_t>(startUs.size());
+        startUs.push_back(SimClock::getTime().asMicroseconds());
+        durationUs.push_back(sf::seconds(tween.duration).asMicroseconds());
+        from.push_back(tween.from);
+        to.push_back(tween.to);
+        ease.push_back(tween.ease);
+        looping.push_back(tween.loop ? 1 : 0);
+        target.push_back(tween.target);
+        callback.push_back(tween.onComplete);
+        context.push_back(tween.context);
+        arg.push_back(tween.arg);
+        slotOf.push_back(slot);
+        if (tween.target) *tween.target = tween.from;
+        Handle handle;
+        handle.slot = slot;
+        handle.generation = generations[slot];
+        return handle;
+    }
+
+    // Stops a tween without running its callback and resets the handle.
+    void cancel(Handle& handle) {
+        std::uint32_t i = denseIndex(handle);
+        if (i != NO_SLOT) remove(i);
+        handle = Handle();
+    }
+
+    bool isActive(Handle handle) const { return denseIndex(handle) != NO_SLOT; }
+    size_t activeCount() const { return startUs.size(); }
+
+    // The value at render time (the last step plus the render lead), for
+    // drawing between steps; `fallback` once the tween is inactive.
+    float sample(Handle handle, float fallback) const {
+        std::uint32_t i = denseIndex(handle);
+        if (i == NO_SLOT) return fallback;
+        return valueAt(i, (SimClock::getTime() + SimClock::getRenderLead()).asMicroseconds());
+    }
+
+    // Advances every tween to `now`. Callbacks run after the pass, so they
+    // may start or cancel tweens freely.
+    void update(sf::Time now) {
+        if (startUs.empty()) return;
+        sf::Int64 nowUs = now.asMicroseconds();
+        for (size_t i = 0; i < startUs.size();) {
+            bool finished = nowUs - startUs[i] >= durationUs[i];
+            if (finished && looping[i] && durationUs[i] > 0) {
+                startUs[i] += (nowUs - startUs[i]) / durationUs[i] * durationUs[i];
+                finished = false;
+                if (callback[i]) completed.push_back({callback[i], context[i], arg[i]});
+            }
+            if (target[i]) *target[i] = valueAt(i, nowUs);
+            if (finished) {
+                if (callback[i]) completed.push_back({callback[i], context[i], arg[i]});
+                remove(i);
+            } else {
+                ++i;
+            }
+        }
+        for (size_t i = 0; i < completed.size(); ++i) completed[i].callback(completed[i].context, completed[i].arg);
+        completed.clear();
+    }
 };
 
-template <typename T>
-class Inventory {
+// --- Screen Fade ---
+// Fade to black, hand control to the owner at full black, then fade back in
+// when the owner calls fadeIn(). Used for screen changes and room changes.
+class ScreenFade {
 private:
-    T* items = nullptr;
-    size_t current_size = 0;
-    size_t capacity = 0;
-    void resize() {
-        capacity = (capacity == 0) ? 2 : capacity * 2;
-        T* newItems = new T[capacity];
-        for (size_t i = 0; i < current_size; ++i) newItems[i] = items[i];
-        delete[] items;
-        items = newItems;
-    }
+    TweenSystem& tweens;
+    TweenSystem::Handle tween;
+    TransitionState state = TransitionState::NONE;
+    float duration;
+
 public:
-    Inventory() = default;
-    ~Inventory() { delete[] items; }
-    Inventory(const Inventory& other) : current_size(other.current_size), capacity(other.capacity) {
-        items = new T[capacity];
-        for (size_t i = 0; i < current_size; ++i) items[i] = other.items[i];
-    }
-    Inventory& operator=(const Inventory& other) {
-        if (this == &other) return *this;
-        delete[] items;
-        current_size = other.current_size;
-        capacity = other.capacity;
-        items = new T[capacity];
-        for (size_t i = 0; i < current_size; ++i) items[i] = other.items[i];
-        return *this;
+    ScreenFade(TweenSystem& tweenSystem, float seconds) : tweens(tweenSystem), duration(seconds) {}
+    ~ScreenFade() { tweens.cancel(tween); }
+    ScreenFade(const ScreenFade&) = delete;
+    ScreenFade& operator=(const ScreenFade&) = delete;
+
+    TransitionState getState() const { return state; }
+    bool isActive() const { return state != TransitionState::NONE; }
+
+    void reset() {
+        tweens.cancel(tween);
+        state = TransitionState::NONE;
     }
 
-    void add(const T& item) { if (current_size == capacity) resize(); items[current_size++] = item; }
-    bool has(const T& item) const {
-        for (size_t i = 0; i < current_size; ++i) if (items[i] == item) return true;
-        return false;
+    // `onBlack` runs once the screen is fully black; the fade stays there
+    // until fadeIn().
+    void fadeOut(TweenSystem::Callback onBlack, void* context, int arg = 0) {
+        tweens.cancel(tween);
+        state = TransitionState::FADING_OUT;
+        tween = tweens.start({0.f, 255.f, duration, Ease::LINEAR, false, nullptr, onBlack, context, arg});
     }
-    size_t size() const { return current_size; }
-    std::string getSortedString() const {
-        if (current_size == 0) return "Empty";
-        T* sorted = new T[current_size];
-        for (size_t i = 0; i < current_size; ++i) sorted[i] = items[i];
-        std::sort(sorted, sorted + current_size);
-        std::stringstream ss;
-        for (size_t i = 0; i < current_size; ++i) ss << sorted[i] << (i == current_size - 1 ? "" : ", ");
-        delete[] sorted;
-        return ss.str();
+
+    void fadeIn() {
+        tweens.cancel(tween);
+        state = TransitionState::FADING_IN;
+        tween = tweens.start({255.f, 0.f, duration, Ease::LINEAR, false, nullptr,
+                              [](void* self, int) { static_cast<ScreenFade*>(self)->state = TransitionState::NONE; }, this});
     }
+
+    // Overlay alpha at render time.
+    sf::Uint8 alpha() const {
+        if (state == TransitionState::NONE) return 0;
+        return static_cast<sf::Uint8>(tweens.sample(tween, state == TransitionState::FADING_OUT ? 255.f : 0.f));
+    }
+};
+
+// --- Texture Atlas ---
+// Animation frames packed into as few textures as the GPU allows. A frame is a
+// page plus a texture rect, so animating moves the rect instead of rebinding.
+struct TextureAtlas {
+    struct Frame {
+        size_t page;
+        sf::IntRect rect;
+    };
+    std::vector<std::unique_ptr<sf::Texture>> pages;
+    std::vector<Frame> frames;
+
+    bool empty() const { return frames.empty(); }
+    size_t size() const { return frames.size(); }
+    const sf::Texture& pageFor(size_t frame) const { return *pages[frame < frames.size() ? frames[frame].page : 0]; }
 };
 
-class Player {
+// CPU-side atlas: decoded page images waiting to be uploaded on the GL thread.
+struct PreparedAtlas {
+    std::vector<sf::Image> pageImages;
+    std::vector<TextureAtlas::Frame> frames;
+};
+
+// Packs images into atlas pages and keeps a packed copy on disk next to the
+// sources (<prefix><id>.atlas plus one PNG per page). The cache is reused as
+// long as every source still has the size and content hash recorded in the
+// index. Hashing reads the compressed files, which costs far less than
+// decoding them.
+class AtlasBuilder {
 private:
-    std::string name;
-    int health;
-    int moves;
-    Inventory<std::string> inventory;
-    bool finalBossDefeated = false;
+    static const int CACHE_VERSION = 2;
+    static const unsigned int PADDING = 2;
+
+    static std::string indexPath(const std::string& id, const std::string& prefix) { return prefix + id + ".atlas"; }
+    static std::string pagePath(const std::string& id, const std::string& prefix, size_t page) {
+        return prefix + id + ".atlas" + std::to_string(page) + ".png";
+    }
+
+    // FNV-1a over the asset's bytes, from the pack or from disk; false if missing.
+    static bool sourceHash(const std::string& path, std::uint64_t& hash) {
+        hash = 14695981039346656037ull;
+        auto mix = [&hash](const char* bytes, size_t count) {
+            for (size_t i = 0; i < count; ++i) hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 1099511628211ull;
+        };
+        AssetPack::Blob blob;
+        if (AssetPack::find(path, blob)) {
+            mix(static_cast<const char*>(blob.data), blob.size);
+            return true;
+        }
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        char buffer[16 * 1024];
+        while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) mix(buffer, static_cast<size_t>(in.gcount()));
+        return true;
+    }
+
+    static bool loadCache(const std::string& id, const std::string& prefix, const std::vector<std::string>& sources, PreparedAtlas& atlas) {
+        std::ifstream index(indexPath(id, prefix));
+        if (!index) return false;
+
+        std::string tag;
+        int version = 0;
+        size_t sourceCount = 0, pageCount = 0, frameCount = 0;
+        if (!(index >> tag >> version) || tag != "atlas" || version != CACHE_VERSION) return false;
+        if (!(index >> tag >> sourceCount) || tag != "sources" || sourceCount != sources.size()) return false;
+        for (size_t i = 0; i < sourceCount; ++i) {
+            std::string path;
+            long long size = 0;
+            std::uint64_t hash = 0, current = 0;
+            if (!(index >> path >> size >> hash) || path != sources[i] || size != AssetPack::assetSize(sources[i])) return false;
+            if (!sourceHash(sources[i], current) || hash != current) return false;
+        }
+        if (!(index >> tag >> pageCount) || tag != "pages") return false;
+        if (!(index >> tag >> frameCount) || tag != "frames" || frameCount != sources.size()) return false;
+
+        std::vector<TextureAtlas::Frame> frames(frameCount);
+        for (auto& frame : frames) {
+            if (!(index >> frame.page >> frame.rect.left >> frame.rect.top >> frame.rect.width >> frame.rect.height)) return false;
+            if (frame.page >= pageCount) return false;
+        }
+
+        std::vector<sf::Image> pages(pageCount);
+        for (size_t i = 0; i < pageCount; ++i) {
+            if (!pages[i].loadFromFile(pagePath(id, prefix, i))) return false;
+        }
+        // A stale or hand-edited index must not hand out rects off its page.
+        for (const auto& frame : frames) {
+            sf::Vector2u pageSize = pages[frame.page].getSize();
+            const sf::IntRect& rect = frame.rect;
+            bool inside = rect.left >= 0 && rect.top >= 0 && rect.width > 0 && rect.height > 0
+                && static_cast<unsigned int>(rect.left) <= pageSize.x && static_cast<unsigned int>(rect.width) <= pageSize.x - rect.left
+                && static_cast<unsigned int>(rect.top) <= pageSize.y && static_cast<unsigned int>(rect.height) <= pageSize.y - rect.top;
+            if (!inside) return false;
+        }
+        atlas.pageImages = std::move(pages);
+        atlas.frames = std::move(frames);
+        return true;
+    }
+
+    static void saveCache(const std::string& id, const std::string& prefix, const std::vector<std::string>& sources, const PreparedAtlas& atlas) {
+        const std::vector<sf::Image>& pageImages = atlas.pageImages;
+        for (size_t i = 0; i < pageImages.size(); ++i) {
+            if (!pageImages[i].saveToFile(pagePath(id, prefix, i))) {
+                std::cerr << "Warning: could not write atlas cache page for: " << id << std::endl;
+                return;
+            }
+        }
+        std::ofstream index(indexPath(id, prefix));
+        index << "atlas " << CACHE_VERSION << "\n";
+        index << "sources " << sources.size() << "\n";
+        for (const auto& path : sources) {
+            std::uint64_t hash = 0;
+            sourceHash(path, hash);
+            index << path << " " << AssetPack::assetSize(path) << " " << hash << "\n";
+        }
+        index << "pages " << pageImages.size() << "\n";
+        index << "frames " << atlas.frames.size() << "\n";
+        for (const auto& frame : atlas.frames) {
+            index << frame.page << " " << frame.rect.left << " " << frame.rect.top << " " << frame.rect.width << " " << frame.rect.height << "\n";
+        }
+    }
+
 public:
-    Player(std::string n, int h, int m) : name(std::move(n)), health(h), moves(m) {}
-
-    std::string getName() const { return name; }
-    int getHealth() const { return health; }
-    int getMoves() const { return moves; }
-    bool isFinalBossDefeated() const { return finalBossDefeated; }
-    const Inventory<std::string>& getInventory() const { return inventory; }
-
-    std::string takeDamage(int damage) {
-        health -= damage;
-        if (health < 0) health = 0;
-        std::stringstream ss;
-        ss << "You took " << damage << " damage!";
-        return ss.str();
-    }
-    void heal(int amount) { health = std::min(100, health + amount); }
-    void useMove() { moves--; } // Allow moves to go into negative to detect game over.
-    void collectItem(const std::string& item) { inventory.add(item); }
-    bool hasItem(const std::string& item) const { return inventory.has(item); }
-    void setBossDefeated(bool status) { finalBossDefeated = status; }
-    // Copy Constructor for the Player class
-Player(const Player& other)
-    : name(other.name),
-      health(other.health),
-      moves(other.moves),
-      inventory(other.inventory), // This correctly calls the Inventory's copy constructor
-      finalBossDefeated(other.finalBossDefeated)
-{
-    // We add this message for demonstration, to see when the copy happens.
-    std::cout 
-    << "[DEBUG] Player copy constructor was called to create a copy of: " << other.name << std::endl;
-}
-// Copy Assignment Operator for the Player class
-Player& operator=(const Player& other) {
-    // We add this message for demonstration.
-    std::cout << "[DEBUG] Player copy assignment operator called to assign from: " << other.name << std::endl;
+    // Shelf-packs the images into pages no larger than maxSize on a side. CPU only.
+    static void pack(const std::vector<sf::Image>& images, unsigned int maxSize, PreparedAtlas& atlas) {
+        atlas.pageImages.clear();
+        atlas.frames.clear();
+        if (images.empty()) return;
+
+        unsigned int widest = 0;
+        for (const auto& image : images) widest = std::max(widest, image.getSize().x + PADDING);
+        unsigned int columns = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<float>(images.size()))));
+        unsigned int pageWidth = std::min(maxSize, std::max(widest, columns * widest));
+
+        // First pass: assign rects and page extents.
+        std::vector<sf::Vector2u> pageSizes;
+        unsigned int x = 0, y = 0, shelfHeight = 0;
+        pageSizes.push_back({0, 0});
+        for (const auto& image : images) {
+            sf::Vector2u size = image.getSize();
+            if (x + size.x > pageWidth) { x = 0; y += shelfHeight + PADDING; shelfHeight = 0; }
+            if (y + size.y > maxSize) { x = 0; y = 0; shelfHeight = 0; pageSizes.push_back({0, 0}); }
+
+            atlas.frames.push_back({pageSizes.size() - 1, sf::IntRect(x, y, size.x, size.y)});
+            sf::Vector2u& page = pageSizes.back();
+            page.x = std::max(page.x, x + size.x);
+            page.y = std::max(page.y, y + size.y);
+            x += size.x + PADDING;
+            shelfHeight = std::max(shelfHeight, size.y);
+        }
 
-    // Step 1: Handle self-assignment. This is a critical check!
-    if (this == &other) {
-        return *this;
+        // Second pass: blit into the page images.
+        atlas.pageImages.resize(pageSizes.size());
+        for (size_t i = 0; i < pageSizes.size(); ++i) atlas.pageImages[i].create(pageSizes[i].x, pageSizes[i].y, sf::Color::Transparent);
+        for (size_t i = 0; i < images.size(); ++i) {
+            const auto& frame = atlas.frames[i];
+            atlas.pageImages[frame.page].copy(images[i], frame.rect.left, frame.rect.top);
+        }
     }
 
-    // Step 2: Copy the data members from the other object to this one.
-    this->name = other.name;
-    this->health = other.health;
-    this->moves = other.moves;
-    this->inventory = other.inventory; // This calls the Inventory's assignment operator
-    this->finalBossDefeated = other.finalBossDefeated;
+    // Decodes `prefix000001.png`... (or the disk cache, when still valid) and
+    // packs them. Touches no GL state, so it is safe on a worker thread.
+    static void prepareFrames(const std::string& id, const std::string& prefix, int frameCount, unsigned int maxSize, PreparedAtlas& atlas) {
+        std::vector<std::string> sources;
+        for (int i = 1; i <= frameCount; ++i) {
+            std::stringstream ss;
+            ss << prefix << std::setw(6) << std::setfill('0') << i << ".png";
+            sources.push_back(ss.str());
+        }
+        if (loadCache(id, prefix, sources, atlas)) return;
+
+        std::vector<sf::Image> images;
+        images.reserve(sources.size());
+        for (const auto& path : sources) {
+            sf::Image image;
+            if (!AssetPack::load(image, path)) {
+                std::cerr << "Error loading background frame: " << path << std::endl;
+                break;
+            }
+            images.push_back(std::move(image));
+        }
+
+        pack(images, maxSize, atlas);
+        if (images.size() == sources.size()) {
+            saveCache(id, prefix, sources, atlas);
+        }
+    }
 
-    // Step 3: Return a reference to the current object to allow for chaining (e.g., a = b = c).
-    return *this;
-}
+    // Uploads prepared pages to textures. GL thread only.
+    static void upload(PreparedAtlas& prepared, TextureAtlas& atlas) {
+        atlas.pages.clear();
+        for (const auto& pageImage : prepared.pageImages) {
+            std::unique_ptr<sf::Texture> page(new sf::Texture());
+            if (!page->loadFromImage(pageImage)) std::cerr << "Error uploading atlas page." << std::endl;
+            atlas.pages.push_back(std::move(page));
+        }
+        atlas.frames = std::move(prepared.frames);
+        prepared.pageImages.clear();
+    }
+
+    static void buildFrames(const std::string& id, const std::string& prefix, int frameCount, TextureAtlas& atlas) {
+        PreparedAtlas prepared;
+        prepareFrames(id, prefix, frameCount, sf::Texture::getMaximumSize(), prepared);
+        upload(prepared, atlas);
+    }
 };
 
-class Room {
+// --- Resource Registry ---
+// Resources are constructed in place in a deque, which keeps their addresses
+// stable (sprites and texts point at them) and indexes them in O(1). Names are
+// hashed only when a handle is resolved; hot paths keep the handle.
+template <typename T>
+class ResourceRegistry {
+private:
+    std::deque<T> items;
+    std::unordered_map<std::string, int> indices;
 public:
-    std::string name;
-    std::string description;
-    std::unique_ptr<Entity> entity;
-    Room* next;
-    bool isFinalDoor = false;
-    bool isChoiceRoom = false;
-    std::string backgroundID;
-
-    Room(std::string n, std::string d, std::string bgID)
-    : name(std::move(n)), description(std::move(d)), entity(nullptr), next(nullptr), backgroundID(std::move(bgID)) {}
+    // Returns the handle for id, creating an empty slot if it is new.
+    int resolve(const std::string& id, bool& created) {
+        auto it = indices.find(id);
+        created = (it == indices.end());
+        if (!created) return it->second;
+        items.emplace_back();
+        int handle = static_cast<int>(items.size() - 1);
+        indices.emplace(id, handle);
+        return handle;
+    }
+    int find(const std::string& id) const {
+        auto it = indices.find(id);
+        return it == indices.end() ? -1 : it->second;
+    }
+    T& at(int handle) { return items[handle]; }
+    size_t size() const { return items.size(); }
 };
 
-class Dungeon {
+struct FontHandle { int index = -1; };
+struct TextureHandle { int index = -1; };
+
+class ResourceManager {
 private:
-    Room* head = nullptr;
-    Room* currentRoom = nullptr;
-    Player& player;
-    Stack<Room*> path_tracker;
+    // Residency bookkeeping for one texture, indexed by its handle.
+    struct TextureSlot {
+        enum class State { UNLOADED, LOADING, LOADED };
+        std::string id;
+        State state = State::UNLOADED;
+        size_t bytes = 0;
+        unsigned long lastUse = 0;
+        bool pinned = false;
+    };
+
+    static ResourceRegistry<sf::Font> fonts;
+    static ResourceRegistry<sf::Texture> textures;
+    static ResourceRegistry<TextureAtlas> atlases;
+    static std::vector<TextureSlot> textureSlots;
+    static size_t textureBytes;
+    static size_t textureBudget;
+    static unsigned long useClock;
+    static unsigned int evictions;
+
+    static void markLoaded(int handle) {
+        TextureSlot& slot = textureSlots[handle];
+        sf::Vector2u size = textures.at(handle).getSize();
+        slot.state = TextureSlot::State::LOADED;
+        slot.bytes = static_cast<size_t>(size.x) * size.y * 4;
+        slot.lastUse = ++useClock;
+        textureBytes += slot.bytes;
+        enforceBudget();
+    }
+
+    static void loadNow(int handle) {
+        TextureSlot& slot = textureSlots[handle];
+        // Prepend assets/ path
+        if (!AssetPack::load(textures.at(handle), "assets/" + slot.id)) {
+            std::cerr << "\n\n======================================================\n";
+            std::cerr << "FATAL ERROR: Could not load texture: 'assets/" << slot.id << "'\n";
+            std::cerr << "Please ensure the file exists in the executable's\n";
+            std::cerr << "'assets' sub-directory and the name is correct.\n";
+            std::cerr << "======================================================\n\n";
+        }
+        markLoaded(handle);
+    }
+
+    // Evicts least-recently-used, unpinned textures until under budget.
+    static void enforceBudget() {
+        while (textureBytes > textureBudget) {
+            int victim = -1;
+            for (size_t i = 0; i < textureSlots.size(); ++i) {
+                const TextureSlot& slot = textureSlots[i];
+                if (slot.state != TextureSlot::State::LOADED || slot.pinned) continue;
+                if (victim < 0 || slot.lastUse < textureSlots[victim].lastUse) victim = static_cast<int>(i);
+            }
+            if (victim < 0) return;
+            textures.at(victim) = sf::Texture();
+            textureBytes -= textureSlots[victim].bytes;
+            textureSlots[victim].bytes = 0;
+            textureSlots[victim].state = TextureSlot::State::UNLOADED;
+            ++evictions;
+        }
+    }
+
 public:
-    explicit Dungeon(Player& p) : player(p) {}
-    ~Dungeon() {
-        Room* current = head;
-        while (current != nullptr) {
-            Room* to_delete = current;
-            current = current->next;
-            delete to_delete;
+    static FontHandle getFontHandle(const std::string& id) {
+        bool created;
+        FontHandle handle{fonts.resolve(id, created)};
+        // MODIFIED: Prepend assets/ path
+        if (created && !AssetPack::load(fonts.at(handle.index), "assets/" + id)) {
+            std::cerr << "Error loading font: " << id << std::endl;
         }
+        return handle;
     }
-    Dungeon(const Dungeon&) = delete;
-    Dungeon& operator=(const Dungeon&) = delete;
 
-    void addRoom(Room* newRoom) {
-        if (!head) { head = currentRoom = newRoom; }
-        else {
-            Room* temp = head;
-            while (temp->next) temp = temp->next;
-            temp->next = newRoom;
+    // Resolves a texture handle without loading it.
+    static TextureHandle findTextureHandle(const std::string& id) {
+        bool created;
+        TextureHandle handle{textures.resolve(id, created)};
+        if (created) {
+            textureSlots.emplace_back();
+            textureSlots.back().id = id;
         }
+        return handle;
+    }
+    static TextureHandle getTextureHandle(const std::string& id) {
+        TextureHandle handle = findTextureHandle(id);
+        if (textureSlots[handle.index].state != TextureSlot::State::LOADED) loadNow(handle.index);
+        return handle;
+    }
+
+    static sf::Font& get(FontHandle handle) { return fonts.at(handle.index); }
+    // Loads synchronously if the texture was evicted or its prefetch has not landed yet.
+    static sf::Texture& get(TextureHandle handle) {
+        TextureSlot& slot = textureSlots[handle.index];
+        if (slot.state != TextureSlot::State::LOADED) loadNow(handle.index);
+        else slot.lastUse = ++useClock;
+        return textures.at(handle.index);
+    }
+
+    static sf::Font& getFont(const std::string& id) { return get(getFontHandle(id)); }
+    static sf::Texture& getTexture(const std::string& id) { return get(getTextureHandle(id)); }
+
+    static TextureAtlas& getAnimationAtlas(const std::string& id, const std::string& prefix, int frameCount) {
+        bool created;
+        TextureAtlas& atlas = atlases.at(atlases.resolve(id, created));
+        if (created) AtlasBuilder::buildFrames(id, prefix, frameCount, atlas);
+        return atlas;
+    }
+
+    // --- Texture Budget ---
+    static void setTextureBudget(size_t bytes) { textureBudget = bytes; enforceBudget(); }
+    static size_t getTextureBytes() { return textureBytes; }
+    // Bumped on every eviction: sprites bound to an evicted texture must
+    // fetch it again through get().
+    static unsigned int getEvictionCount() { return evictions; }
+
+    // Pins exactly the given textures (the rooms around the player), then evicts
+    // whatever no longer fits. Pinned textures are never evicted.
+    static void retainTextures(const std::vector<TextureHandle>& keep) {
+        for (auto& slot : textureSlots) slot.pinned = false;
+        for (TextureHandle handle : keep) {
+            textureSlots[handle.index].pinned = true;
+            textureSlots[handle.index].lastUse = ++useClock;
+        }
+        enforceBudget();
+    }
+
+    // --- Hooks for AssetLoader (GL thread) ---
+    // Marks an unloaded texture as in flight. Returns false if there is nothing to fetch.
+    static bool beginPrefetch(TextureHandle handle) {
+        TextureSlot& slot = textureSlots[handle.index];
+        if (slot.state != TextureSlot::State::UNLOADED) return false;
+        slot.state = TextureSlot::State::LOADING;
+        return true;
+    }
+    static bool hasAtlas(const std::string& id) { return atlases.find(id) >= 0; }
+    static void storeTexture(const std::string& id, const sf::Image& image) {
+        TextureHandle handle = findTextureHandle(id);
+        if (textureSlots[handle.index].state == TextureSlot::State::LOADED) return; // Already loaded synchronously.
+        if (!textures.at(handle.index).loadFromImage(image)) std::cerr << "Error uploading texture: " << id << std::endl;
+        markLoaded(handle.index);
+    }
+    // A failed background decode: forget the request so get() retries and reports it.
+    static void cancelPrefetch(const std::string& id) {
+        TextureHandle handle = findTextureHandle(id);
+        if (textureSlots[handle.index].state == TextureSlot::State::LOADING) textureSlots[handle.index].state = TextureSlot::State::UNLOADED;
     }
+    static void storeAtlas(const std::string& id, PreparedAtlas& prepared) {
+        bool created;
+        AtlasBuilder::upload(prepared, atlases.at(atlases.resolve(id, created)));
+    }
+};
+MappedFile AssetPack::file;
+const PackFormat::PackEntry* AssetPack::entries = nullptr;
+std::uint32_t AssetPack::entryCount = 0;
+
+ResourceRegistry<sf::Font> ResourceManager::fonts;
+ResourceRegistry<sf::Texture> ResourceManager::textures;
+ResourceRegistry<TextureAtlas> ResourceManager::atlases;
+std::vector<ResourceManager::TextureSlot> ResourceManager::textureSlots;
+size_t ResourceManager::textureBytes = 0;
+size_t ResourceManager::textureBudget = GameConfig::TEXTURE_BUDGET_BYTES;
+unsigned long ResourceManager::useClock = 0;
+unsigned int ResourceManager::evictions = 0;
+
+// A room's background handle, resolved from its name once and then cached
+// on the room, so later lookups skip the string map.
+inline TextureHandle backgroundOf(const Dungeon& dungeon, Room& room) {
+    if (room.backgroundHandle < 0) room.backgroundHandle = ResourceManager::findTextureHandle(dungeon.backgroundOf(room)).index;
+    return TextureHandle{room.backgroundHandle};
+}
+
+// --- Asynchronous Asset Loader ---
+// A persistent pool of worker threads that decode queued images into
+// sf::Image. The main (GL) thread uploads finished results into
+// ResourceManager a few per frame via pump(). Jobs are served in the order
+// they were queued; idle workers sleep on a condition variable.
+class AssetLoader {
+private:
+    enum class JobType { TEXTURE, ATLAS };
+    struct Job {
+        JobType type;
+        std::string id;
+        std::string prefix;
+        int frameCount;
+    };
+    struct Result {
+        Job job;
+        bool ok = false;
+        sf::Image image;
+        PreparedAtlas atlas;
+    };
 
-    Room* getCurrentRoom() const { return currentRoom; }
-    bool canMoveBack() const { return !path_tracker.isEmpty(); }
-    bool canMoveForward() const { return currentRoom && currentRoom->next; }
+    std::vector<std::thread> workers;
+    bool stopping = false;
+    unsigned int maxTextureSize = 0;
+
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<Job> pending;
+
+    std::mutex readyMutex;
+    std::deque<Result> ready;
+
+    size_t queued = 0;   // Main thread only.
+    size_t uploaded = 0; // Main thread only.
+
+    void workerLoop() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [this]() { return stopping || !pending.empty(); });
+                if (stopping) return;
+                job = std::move(pending.front());
+                pending.pop_front();
+            }
 
-    void moveForward() {
-        if (canMoveForward()) {
-            player.useMove();
-            path_tracker.push(currentRoom);
-            currentRoom = currentRoom->next;
+            Result result;
+            if (job.type == JobType::TEXTURE) {
+                result.ok = AssetPack::load(result.image, "assets/" + job.id);
+            } else {
+                AtlasBuilder::prepareFrames(job.id, job.prefix, job.frameCount, maxTextureSize, result.atlas);
+                result.ok = true;
+            }
+            result.job = std::move(job);
+
+            std::lock_guard<std::mutex> lock(readyMutex);
+            ready.push_back(std::move(result));
         }
     }
 
-    void moveBack() {
-        if (canMoveBack()) {
-            player.useMove();
-            currentRoom = path_tracker.top();
-            path_tracker.pop();
+    void push(Job job) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            pending.push_back(std::move(job));
         }
+        queued++;
+        queueReady.notify_one();
     }
-};
 
-void Item::interact(Player& player, std::string& interactionResult) {
-    if (dynamic_cast<Potion*>(this)) {
-        player.heal(100);
-        interactionResult = "You drank the potion and feel fully restored!";
-    } else {
-        player.collectItem(this->getName());
-        interactionResult = "You picked up the " + this->getName() + ".";
+    void upload(Result& result) {
+        const Job& job = result.job;
+        if (job.type == JobType::TEXTURE) {
+            if (result.ok) ResourceManager::storeTexture(job.id, result.image);
+            else ResourceManager::cancelPrefetch(job.id);
+        } else {
+            ResourceManager::storeAtlas(job.id, result.atlas);
+        }
+        uploaded++;
     }
-}
 
-void Enemy::interact(Player& player, std::string& interactionResult) {
-    interactionResult = "";
-}
+public:
+    AssetLoader() = default;
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+    ~AssetLoader() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
 
-void BossEnemy::interact(Player& player, std::string& interactionResult) {
-    interactionResult = "";
-}
+    // Queues a texture unless it is already resident or in flight.
+    void queueTexture(const std::string& id) {
+        TextureHandle handle = ResourceManager::findTextureHandle(id);
+        if (ResourceManager::beginPrefetch(handle)) push({JobType::TEXTURE, id, "", 0});
+    }
+    void queueAtlas(const std::string& id, const std::string& prefix, int frameCount) { push({JobType::ATLAS, id, prefix, frameCount}); }
 
+    void start() {
+        maxTextureSize = sf::Texture::getMaximumSize(); // Needs the GL context, so query it here.
+        unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+        unsigned int count = std::min(hardware, GameConfig::MAX_LOADER_THREADS);
+        for (unsigned int i = 0; i < count; ++i) workers.emplace_back(&AssetLoader::workerLoop, this);
+    }
 
-// =================================================================
-// 2. GUI FRAMEWORK & SCREENS
-// =================================================================
-class Game;
+    // Uploads up to maxUploads decoded results. Call from the GL thread.
+    void pump(size_t maxUploads) {
+        for (size_t i = 0; i < maxUploads; ++i) {
+            Result result;
+            {
+                std::lock_guard<std::mutex> lock(readyMutex);
+                if (ready.empty()) return;
+                result = std::move(ready.front());
+                ready.pop_front();
+            }
+            upload(result);
+        }
+    }
 
-namespace Utils {
-    void centerOrigin(sf::Text& text) {
-        sf::FloatRect bounds = text.getLocalBounds();
-        text.setOrigin(bounds.left + bounds.width / 2.0f, bounds.top + bounds.height / 2.0f);
+    // Blocks until every job queued so far is decoded and uploaded.
+    void finish() {
+        while (!isDone()) {
+            pump(queued);
+            if (!isDone()) std::this_thread::yield();
+        }
     }
 
-    void centerOrigin(sf::Sprite& sprite) {
-        sf::FloatRect bounds = sprite.getLocalBounds();
-        sprite.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
+    bool isDone() const { return uploaded == queued; }
+    float progress() const { return queued == 0 ? 1.f : static_cast<float>(uploaded) / queued; }
+};
+
+// --- Background Save Writer ---
+// Snapshots are taken on the main thread, which costs microseconds; the
+// file write runs on one worker so a slow disk never stalls a frame. A save
+// queued while another is waiting replaces it, since only the newest
+// matters. Files are written beside the target and renamed into place, so
+// a crash mid-write keeps the previous save intact.
+class SaveWriter {
+private:
+    std::thread worker;
+    bool stopping = false;
+    bool hasPending = false;
+    std::string pendingPath;
+    std::string pendingBytes;
+    std::deque<bool> finished; // Results of completed writes, oldest first.
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    static bool writeFile(const std::string& path, const std::string& bytes) {
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            out.close(); // A failed flush shows up here, not in write().
+            if (!out.good()) return false;
+        }
+    #ifdef _WIN32
+        // rename() will not replace an existing file on Windows.
+        return MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    #else
+        return std::rename(temporary.c_str(), path.c_str()) == 0;
+    #endif
     }
 
-    void centerOrigin(sf::RectangleShape& rect) {
-        sf::Vector2f size = rect.getSize();
-        rect.setOrigin(size.x / 2.0f, size.y / 2.0f);
+    void writerLoop() {
+        std::string path, bytes;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this]() { return stopping || hasPending; });
+                if (!hasPending) return; // A save queued before shutdown is still written.
+                path.swap(pendingPath);
+                bytes.swap(pendingBytes);
+                hasPending = false;
+            }
+            bool ok = writeFile(path, bytes);
+            if (!ok) std::cerr << "Could not write save file: " << path << std::endl;
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.push_back(ok);
+        }
     }
 
-    void wrapText(sf::Text& text, float maxWidth) {
-        std::string string = text.getString();
-        if (string.empty()) return;
+public:
+    SaveWriter() : worker(&SaveWriter::writerLoop, this) {}
+    SaveWriter(const SaveWriter&) = delete;
+    SaveWriter& operator=(const SaveWriter&) = delete;
+    ~SaveWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
 
-        std::string wrappedString;
-        std::string currentLine;
-        std::stringstream ss(string);
-        std::string word;
+    void save(const std::string& path, std::string bytes) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingPath = path;
+            pendingBytes = std::move(bytes);
+            hasPending = true;
+        }
+        wake.notify_one();
+    }
+
+    // Takes the result of the oldest finished write, if any.
+    bool pollFinished(bool& ok) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (finished.empty()) return false;
+        ok = finished.front();
+        finished.pop_front();
+        return true;
+    }
+};
+
+// --- Input Recording ---
+// A recording is the RNG seed plus every input event, stamped with the
+// fixed-step tick it was handled before. Ticks count from the loading
+// screen's hand-over to the menu, the first point where timing no longer
+// depends on how fast assets decode, so a replay lines up step for step.
+// Text format, one entry per line:
+//   dungeon-replay 1
+//   seed <n>
+//   end <tick>                       the tick recording stopped at
+//   <tick> key <code> <alt> <control> <shift> <system>
+//   <tick> text <unicode>
+//   <tick> resize <width> <height>
+class InputLog {
+public:
+    static const int VERSION = 1;
+    struct Entry {
+        std::uint64_t tick;
+        sf::Event event;
+    };
 
-        while (ss >> word) {
-            sf::Text tempText = text;
-            std::string testLine = currentLine.empty() ? word : currentLine + " " + word;
-            tempText.setString(testLine);
+    std::uint32_t seed = 0;
+    std::uint64_t endTick = 0;
+    std::vector<Entry> entries;
+
+    // Game input only: the profiler keys (F3-F5) stay live during a replay.
+    static bool records(const sf::Event& event) {
+        switch (event.type) {
+            case sf::Event::KeyPressed: return event.key.code < sf::Keyboard::F3 || event.key.code > sf::Keyboard::F5;
+            case sf::Event::TextEntered:
+            case sf::Event::Resized: return true;
+            default: return false;
+        }
+    }
 
-            if (tempText.getGlobalBounds().width > maxWidth && !currentLine.empty()) {
-                wrappedString += currentLine + "\n";
-                currentLine = word;
+    bool save(const std::string& path) const {
+        std::ofstream out(path);
+        out << "dungeon-replay " << VERSION << "\nseed " << seed << "\nend " << endTick << '\n';
+        for (const Entry& entry : entries) {
+            const sf::Event& event = entry.event;
+            out << entry.tick;
+            if (event.type == sf::Event::KeyPressed) {
+                out << " key " << static_cast<int>(event.key.code) << ' ' << event.key.alt << ' ' << event.key.control
+                    << ' ' << event.key.shift << ' ' << event.key.system;
+            } else if (event.type == sf::Event::TextEntered) {
+                out << " text " << event.text.unicode;
             } else {
-                if (!currentLine.empty()) currentLine += " ";
-                currentLine += word;
+                out << " resize " << event.size.width << ' ' << event.size.height;
             }
+            out << '\n';
         }
-        wrappedString += currentLine;
-        text.setString(wrappedString);
+        return out.good();
     }
 
-    float lerp(float a, float b, float t) { return a + t * (b - a); }
-    float clamp(float value, float min, float max) { return std::max(min, std::min(value, max)); }
-}
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream in(path);
+        if (!in) { error = "cannot open " + path; return false; }
+        std::string magic, seedKey, endKey;
+        int version = 0;
+        if (!(in >> magic >> version >> seedKey >> seed >> endKey >> endTick) || magic != "dungeon-replay" || seedKey != "seed" || endKey != "end") {
+            error = "not a replay file";
+            return false;
+        }
+        if (version != VERSION) { error = "unsupported replay version " + std::to_string(version); return false; }
+
+        entries.clear();
+        std::string line;
+        int lineNumber = 3;
+        std::getline(in, line);
+        while (std::getline(in, line)) {
+            ++lineNumber;
+            if (line.empty()) continue;
+            std::istringstream fields(line);
+            Entry entry;
+            std::string type;
+            bool ok = static_cast<bool>(fields >> entry.tick >> type);
+            if (ok && type == "key") {
+                int code = 0, alt = 0, control = 0, shift = 0, system = 0;
+                ok = static_cast<bool>(fields >> code >> alt >> control >> shift >> system);
+                entry.event.type = sf::Event::KeyPressed;
+                entry.event.key.code = static_cast<sf::Keyboard::Key>(code);
+                entry.event.key.alt = alt != 0;
+                entry.event.key.control = control != 0;
+                entry.event.key.shift = shift != 0;
+                entry.event.key.system = system != 0;
+            } else if (ok && type == "text") {
+                entry.event.type = sf::Event::TextEntered;
+                ok = static_cast<bool>(fields >> entry.event.text.unicode);
+            } else if (ok && type == "resize") {
+                entry.event.type = sf::Event::Resized;
+                ok = static_cast<bool>(fields >> entry.event.size.width >> entry.event.size.height);
+            } else {
+                ok = false;
+            }
+            if (ok && !entries.empty() && entry.tick < entries.back().tick) ok = false;
+            if (!ok) { error = "line " + std::to_string(lineNumber) + ": bad entry"; return false; }
+            entries.push_back(entry);
+        }
+        return true;
+    }
+};
 
-class ResourceManager {
+// --- Action Log ---
+// The last few session log lines, stored inline in a fixed ring of
+// fixed-size slots. A line is formatted from its template straight into
+// the ring, so writing one allocates nothing; a line equal to the newest
+// is dropped. The display text ("- line" per row, newest first) is
+// rebuilt only when a line arrives.
+class ActionLog {
+public:
+    static const size_t CAPACITY = 4;
+    static const size_t MAX_LINE_LENGTH = 95; // Longer lines are truncated.
+
+private:
+    char lines[CAPACITY][MAX_LINE_LENGTH + 1];
+    size_t lengths[CAPACITY] = {};
+    size_t newest = 0;
+    size_t count = 0;
+    std::string display;
+    bool displayStale = false;
+
+public:
+    ActionLog() { display.reserve(CAPACITY * (MAX_LINE_LENGTH + 3)); }
+
+    void clear() { count = 0; display.clear(); displayStale = false; }
+
+    // Returns false if the line was empty or repeated the newest one.
+    bool write(const char* format, const std::string& arg = std::string()) {
+        size_t slot = count == 0 ? 0 : (newest + 1) % CAPACITY;
+        char scratch[MAX_LINE_LENGTH + 1];
+        size_t length = formatLogLine(format, arg, scratch, sizeof(scratch));
+        if (length == 0) return false;
+        if (count > 0 && lengths[newest] == length && std::memcmp(lines[newest], scratch, length) == 0) return false;
+        std::memcpy(lines[slot], scratch, length + 1);
+        lengths[slot] = length;
+        newest = slot;
+        if (count < CAPACITY) count++;
+        displayStale = true;
+        return true;
+    }
+    bool write(LogLine line, const std::string& arg) { return write(logTemplate(line), arg); }
+
+    const std::string& text() {
+        if (!displayStale) return display;
+        display.clear();
+        for (size_t i = 0; i < count; ++i) {
+            size_t slot = (newest + CAPACITY - i) % CAPACITY;
+            display += "- ";
+            display.append(lines[slot], lengths[slot]);
+            display += '\n';
+        }
+        displayStale = false;
+        return display;
+    }
+};
+
+// --- Fitted Backgrounds ---
+// Room and game-over backgrounds are fitted to the logical screen (scaled to
+// fit, centred). Game::handleResize() reports how many screen pixels a
+// logical unit covers; a background larger than the area it covers is then
+// rendered once, smoothed and from mipmaps when enabled, into a texture
+// of exactly that size and drawn as a 1:1 blit. Those textures are cached
+// per (texture, size) with a small LRU bound. Smaller sources (magnified)
+// are drawn directly, as are all sources where render textures are
+// unavailable.
+class BackgroundCache {
 private:
-    static std::map<std::string, sf::Font> fonts;
-    static std::map<std::string, sf::Texture> textures;
-    static std::map<std::string, std::vector<sf::Texture>> texture_frames;
+    struct Entry {
+        int handle;
+        sf::Vector2u pixels;
+        std::unique_ptr<sf::RenderTexture> texture;
+        unsigned long lastUse;
+    };
+    static std::vector<Entry> entries;
+    static float pixelScale; // Screen pixels per logical unit.
+    static unsigned int generation;
+    static unsigned long useClock;
+
 public:
-    static sf::Font& getFont(const std::string& id) {
-        if (fonts.find(id) == fonts.end()) {
-            sf::Font font;
-            // MODIFIED: Prepend assets/ path
-            if (!font.loadFromFile("assets/" + id)) { std::cerr << "Error loading font: " << id << std::endl; }
-            fonts[id] = font;
-        }
-        return fonts[id];
-    }
-    static sf::Texture& getTexture(const std::string& id) {
-        if (textures.find(id) == textures.end()) {
-            sf::Texture tex;
-             // Prepend assets/ path
-            if (!tex.loadFromFile("assets/" + id)) {
-                std::cerr << "\n\n======================================================\n";
-                std::cerr << "FATAL ERROR: Could not load texture: 'assets/" << id << "'\n";
-                std::cerr << "Please ensure the file exists in the executable's\n";
-                std::cerr << "'assets' sub-directory and the name is correct.\n";
-                std::cerr << "======================================================\n\n";
+    // Changing the scale drops every cached texture and re-places every
+    // FittedBackground on its next draw.
+    static void setPixelScale(float scale) {
+        if (scale == pixelScale) return;
+        pixelScale = scale;
+        entries.clear();
+        ++generation;
+    }
+    static float getPixelScale() { return pixelScale; }
+    // Changes whenever previously returned textures may have gone, whether
+    // dropped here or a source evicted by the ResourceManager's budget.
+    static unsigned int getGeneration() { return generation + ResourceManager::getEvictionCount(); }
+
+    // `source` rendered at `pixels`; nullptr if it cannot be.
+    static const sf::Texture* scaled(TextureHandle handle, sf::Texture& source, sf::Vector2u pixels) {
+        for (Entry& entry : entries) {
+            if (entry.handle == handle.index && entry.pixels == pixels) {
+                entry.lastUse = ++useClock;
+                return &entry.texture->getTexture();
             }
-            textures[id] = tex;
-        }
-        return textures[id];
-    }
-    static std::vector<sf::Texture>& getBackgroundFrames(const std::string& id, const std::string& prefix, int frameCount) {
-        if (texture_frames.find(id) == texture_frames.end()) {
-            std::vector<sf::Texture> frames;
-            frames.reserve(frameCount);
-            for (int i = 1; i <= frameCount; ++i) {
-                sf::Texture tex;
-                std::stringstream ss;
-                ss << prefix << std::setw(6) << std::setfill('0') << i << ".png";
-                if (!tex.loadFromFile(ss.str())) {
-                    std::cerr << "Error loading background frame: " << ss.str() << std::endl;
-                    break;
-                }
-                frames.push_back(tex);
+        }
+
+        PROFILE_SCOPE("background.prescale");
+        std::unique_ptr<sf::RenderTexture> texture = std::make_unique<sf::RenderTexture>();
+        if (!texture->create(pixels.x, pixels.y)) return nullptr;
+        sf::Vector2u sourceSize = source.getSize();
+        if (GameConfig::BACKGROUND_MIPMAPS && pixels.x * 2 <= sourceSize.x) source.generateMipmap();
+        source.setSmooth(GameConfig::BACKGROUND_SMOOTH);
+        sf::Sprite sprite(source);
+        sprite.setScale(static_cast<float>(pixels.x) / sourceSize.x, static_cast<float>(pixels.y) / sourceSize.y);
+        texture->clear(sf::Color::Black);
+        texture->draw(sprite);
+        texture->display();
+        texture->setSmooth(GameConfig::BACKGROUND_SMOOTH);
+
+        if (entries.size() >= GameConfig::BACKGROUND_CACHE_ENTRIES) {
+            size_t victim = 0;
+            for (size_t i = 1; i < entries.size(); ++i) {
+                if (entries[i].lastUse < entries[victim].lastUse) victim = i;
             }
-            texture_frames[id] = frames;
+            entries.erase(entries.begin() + victim);
+            ++generation; // Someone may still be drawing the evicted texture.
         }
-        return texture_frames[id];
+        entries.push_back({handle.index, pixels, std::move(texture), ++useClock});
+        return &entries.back().texture->getTexture();
+    }
+};
+std::vector<BackgroundCache::Entry> BackgroundCache::entries;
+float BackgroundCache::pixelScale = 1.f;
+unsigned int BackgroundCache::generation = 1;
+unsigned long BackgroundCache::useClock = 0;
+
+// A background sprite whose texture and transform are worked out when the
+// texture or the pixel scale changes, not every frame.
+class FittedBackground {
+private:
+    sf::Sprite sprite;
+    TextureHandle handle;
+    unsigned int generation = 0;
+    bool drawable = false;
+
+    void place() {
+        generation = BackgroundCache::getGeneration();
+        sf::Texture& source = ResourceManager::get(handle);
+        sf::Vector2u sourceSize = source.getSize();
+        drawable = sourceSize.x > 0 && sourceSize.y > 0;
+        if (!drawable) return;
+
+        sf::Vector2f logical(static_cast<float>(GameConfig::WINDOW_WIDTH), static_cast<float>(GameConfig::WINDOW_HEIGHT));
+        float fit = std::min(logical.x / sourceSize.x, logical.y / sourceSize.y);
+        sf::Vector2f size(sourceSize.x * fit, sourceSize.y * fit);
+        sf::Vector2u pixels(static_cast<unsigned int>(size.x * BackgroundCache::getPixelScale() + 0.5f),
+                            static_cast<unsigned int>(size.y * BackgroundCache::getPixelScale() + 0.5f));
+
+        const sf::Texture* texture = nullptr;
+        if (pixels.x > 0 && pixels.y > 0 && pixels.x < sourceSize.x) texture = BackgroundCache::scaled(handle, source, pixels);
+        if (!texture) texture = &source;
+        sf::Vector2u textureSize = texture->getSize();
+        sprite.setTexture(*texture, true);
+        sprite.setScale(size.x / textureSize.x, size.y / textureSize.y);
+        sprite.setPosition((logical.x - size.x) / 2.f, (logical.y - size.y) / 2.f);
+    }
+
+public:
+    void setTexture(TextureHandle texture) {
+        if (texture.index == handle.index) return;
+        handle = texture;
+        generation = 0;
+    }
+
+    void draw(sf::RenderTarget& target) {
+        if (handle.index >= 0 && generation != BackgroundCache::getGeneration()) place();
+        if (handle.index >= 0 && drawable) target.draw(sprite);
+        else target.clear(sf::Color(10, 0, 10));
     }
 };
-std::map<std::string, sf::Font> ResourceManager::fonts;
-std::map<std::string, sf::Texture> ResourceManager::textures;
-std::map<std::string, std::vector<sf::Texture>> ResourceManager::texture_frames;
 
 class Screen {
 public:
     virtual ~Screen() = default;
     virtual void handleEvent(sf::Event& event, Game& game) = 0;
     virtual void update(sf::Time dt, Game& game) = 0;
-    virtual void draw(sf::RenderWindow& window) = 0;
+    virtual void draw(sf::RenderTarget& window) = 0;
+    // Full-screen effects wanted this frame, sampled at the render lead.
+    virtual void addEffects(PostEffects& effects) {}
     virtual void onEnter(Game& game) {}
+    virtual void onExit(Game& game) {}
     virtual void onResize(unsigned int width, unsigned int height) = 0;
 };
 
+// --- Screen Manager ---
+// One slot per GameStateID. Every screen is built once, while the loading
+// screen is still up, and reused: onEnter() resets a screen for another
+// visit, so changing screens is an array index and never allocates.
+class ScreenManager {
+private:
+    std::unique_ptr<Screen> slots[static_cast<size_t>(GameStateID::COUNT)];
+public:
+    void add(GameStateID id, std::unique_ptr<Screen> screen) { slots[static_cast<size_t>(id)] = std::move(screen); }
+    bool has(GameStateID id) const { return get(id) != nullptr; }
+    // nullptr for NONE and for screens not built yet.
+    Screen* get(GameStateID id) const { return slots[static_cast<size_t>(id)].get(); }
+    template <typename T>
+    T& as(GameStateID id) const { return static_cast<T&>(*get(id)); }
+};
+
+// --- Profiler Overlay ---
+// Toggled with F3. Shows frame time percentiles over the profiler's history
+// and the average inclusive time of every phase. The text is rebuilt a few
+// times a second so the overlay does not dominate what it measures.
+class ProfilerOverlay {
+private:
+    sf::RectangleShape panel;
+    sf::Text text;
+    sf::Clock refreshClock;
+    bool visible = false;
+
+public:
+    void setFont(const sf::Font& font) {
+        text.setFont(font);
+        text.setCharacterSize(16);
+        text.setFillColor(GameConfig::OFF_WHITE_COLOR);
+        text.setPosition(18.f, 14.f);
+        panel.setPosition(10.f, 10.f);
+        panel.setFillColor(sf::Color(0, 0, 0, 180));
+    }
+
+    bool isVisible() const { return visible; }
+    void toggle() {
+        visible = !visible;
+        Profiler::setEnabled(visible || Profiler::isCapturing());
+        refreshClock.restart();
+        text.setString(visible ? "Profiling..." : "");
+    }
+
+    void update(const char* pacing) {
+        if (!visible || refreshClock.getElapsedTime().asSeconds() < GameConfig::PROFILER_OVERLAY_REFRESH) return;
+        refreshClock.restart();
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2);
+        float average = Profiler::averageFrameMs();
+        ss << "Frame " << average << " ms (" << (average > 0.f ? 1000.f / average : 0.f) << " fps)\n";
+        ss << "p50 " << Profiler::frameTimePercentile(0.50f) << "  p95 " << Profiler::frameTimePercentile(0.95f)
+           << "  p99 " << Profiler::frameTimePercentile(0.99f) << " ms\n";
+        ss << "Allocs " << Profiler::averageAllocations() << " / frame (" << Profiler::averageAllocatedBytes() << " B)"
+           << "  arena peak " << FrameArena::getHighWater() << " B\n";
+        for (int i = 0; i < Profiler::phaseCount(); ++i) {
+            ss << Profiler::phaseName(i) << "  " << Profiler::averagePhaseMs(i) << " ms  "
+               << Profiler::averagePhaseAllocations(i) << " allocs\n";
+        }
+        ss << "[F5] Pacing: " << pacing << "\n";
+        if (Profiler::isCapturing()) ss << "[F4] Capturing " << Profiler::capturedFrameCount() << " frames";
+        text.setString(ss.str());
+        sf::FloatRect bounds = text.getGlobalBounds();
+        panel.setSize(sf::Vector2f(bounds.width + 20.f, bounds.top + bounds.height)); // 10px margin below the text.
+    }
+
+    void draw(sf::RenderWindow& window) {
+        if (!visible) return;
+        window.draw(panel);
+        window.draw(text);
+    }
+};
+
 class Game {
 public:
     sf::RenderWindow window;
     sf::View mainView;
-    std::map<GameStateID, std::unique_ptr<Screen>> screens;
+    TweenSystem tweens; // Declared before the screens, which cancel their tweens on destruction.
+    ScreenManager screens;
     GameStateID currentStateID = GameStateID::NONE;
     GameStateID nextStateID = GameStateID::NONE;
-    TransitionState currentTransition = TransitionState::NONE;
-    sf::Clock transitionClock;
-    sf::RectangleShape transitionRect;
-    sf::Clock gameClock;
+    ScreenFade screenFade{tweens, GameConfig::TRANSITION_DURATION};
+    PostProcess postProcess;
+    PacingMode pacing = PacingMode::LIMITED;
+    sf::Clock pacingClock;
+    // --- Power Saving ---
+    // Frames are drawn only when something on screen can have changed, and
+    // the loop sleeps while nothing does or the window is in the background.
+    bool powerSaving = true;
+    bool focused = true;
+    bool redrawRequested = true; // Input or a screen changed the picture.
+    bool redrawPending = false;  // The last frame was active; draw its final state.
+    sf::Time nextFrameDeadline;
     std::string playerName;
-    std::unique_ptr<Player> playerLogic;
-    std::unique_ptr<Dungeon> dungeonLogic;
+    std::unique_ptr<GameSession> session;
+    AssetLoader assetLoader;
+    SaveWriter saveWriter;
+    AudioEngine audio;
 
     // --- Screen Shake Members ---
-    bool isShaking = false;
-    float shakeDuration = 0.f;
-    float shakeMagnitude = 0.f;
-    sf::Clock shakeClock;
+    TweenSystem::Handle shakeTween;
+    float shakeMagnitude = 0.f; // Eased to zero by shakeTween.
+    sf::Vector2f shakeOffset;   // This tick's random offset, applied by postProcess.
     std::mt19937 rng{std::random_device{}()};
 
-    Game();
+    ProfilerOverlay profilerOverlay;
+
+    // --- Input Recording & Replay (see InputLog) ---
+    enum class InputMode { LIVE, RECORDING, REPLAY };
+    InputMode inputMode = InputMode::LIVE;
+    InputLog inputLog;
+    std::string recordPath;
+    bool inputClockStarted = false;
+    std::uint64_t inputTick = 0;
+    size_t replayCursor = 0;
+    Outcome lastOutcome = Outcome::NONE; // Of the most recent finished session.
+
+    explicit Game(PacingMode pacingMode = PacingMode::LIMITED);
     void run();
+    void recordInput(const std::string& path);
+    bool loadReplay(const std::string& path);
+    int runReplay(bool draw, const std::string& expectedOutcome, bool checkAllocations);
+    void setPacing(PacingMode mode);
+    static const char* pacingName(PacingMode mode);
+    void setPowerSaving(bool enabled) { powerSaving = enabled; }
+    void setPostShader(bool enabled) { postProcess.init(enabled); }
+    // Screens call this when update() changed what they draw.
+    void requestRedraw() { redrawRequested = true; }
     void changeScreen(GameStateID newStateID);
     void startGameplay();
     void handleResize(unsigned int width, unsigned int height);
     void triggerScreenShake(float duration, float magnitude);
+    void prefetchAround(Dungeon& dungeon);
+    void loadLevel(Dungeon& dungeon);
 private:
     void processEvents();
+    void dispatchEvent(sf::Event& event);
+    void simulate(sf::Time step);
     void update(sf::Time dt);
     void render();
-    void handleScreenTransition(sf::Time dt);
+    void enterNextScreen();
     void updateScreenShake();
+    void handleProfilerKeys(const sf::Event& event);
+    void paceFrame();
+    bool isAnimating() const;
+    void throttle(const sf::Clock& frameClock, bool active);
+    static const char* screenPhase(GameStateID id, bool draw);
+    static MusicId screenMusic(GameStateID id);
 };
 
 class AnimatedScreen : public Screen {
 public:
     sf::Sprite backgroundSprite;
-    std::vector<sf::Texture>& bgFrames;
+    TextureAtlas& bgAtlas;
     int currentBgFrame = 0;
-    float bgFrameTimer = 0.f;
+    TweenSystem* tweens = nullptr; // Set on enter.
+    TweenSystem::Handle frameTween;
+    sf::Vector2i placedSize; // Frame size the sprite transform was worked out for.
+    LayerCache layer; // The screen's static text; the animated background draws beneath it every frame.
 
     AnimatedScreen(const std::string& frame_id, const std::string& prefix, int frameCount)
-    : bgFrames(ResourceManager::getBackgroundFrames(frame_id, prefix, frameCount))
+    : bgAtlas(ResourceManager::getAnimationAtlas(frame_id, prefix, frameCount))
     {
-        if (!bgFrames.empty()) {
-            backgroundSprite.setTexture(bgFrames[0]);
-        }
+        showFrame(0);
     }
 
-    void updateAnimation(sf::Time dt) {
-        if (bgFrames.empty() || bgFrames.size() <= 1) return;
+    void showFrame(int frame) {
+        if (bgAtlas.empty()) return;
+        const sf::Texture& page = bgAtlas.pageFor(frame);
+        if (backgroundSprite.getTexture() != &page) backgroundSprite.setTexture(page);
+        sf::IntRect rect = bgAtlas.frames[frame].rect;
+        backgroundSprite.setTextureRect(rect);
+        if (rect.width != placedSize.x || rect.height != placedSize.y) placeBackground();
+    }
 
-        bgFrameTimer += dt.asSeconds();
-        if (bgFrameTimer >= GameConfig::BG_ANIMATION_DELAY) {
-            bgFrameTimer -= GameConfig::BG_ANIMATION_DELAY;
-            currentBgFrame = (currentBgFrame + 1) % bgFrames.size();
-            backgroundSprite.setTexture(bgFrames[currentBgFrame]);
-        }
+    // Fits the frame to the logical screen; only needed when the frame size changes.
+    void placeBackground() {
+        sf::Vector2f targetSize(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
+        sf::IntRect frameRect = backgroundSprite.getTextureRect();
+        placedSize = sf::Vector2i(frameRect.width, frameRect.height);
+        if (frameRect.width <= 0 || frameRect.height <= 0) return;
+        float scale = std::min(targetSize.x / frameRect.width, targetSize.y / frameRect.height);
+        backgroundSprite.setScale(scale, scale);
+        Utils::centerOrigin(backgroundSprite);
+        backgroundSprite.setPosition(targetSize.x / 2.0f, targetSize.y / 2.0f);
     }
 
+    ~AnimatedScreen() override { if (tweens) tweens->cancel(frameTween); }
+
     void onEnter(Game& game) override {
-        bgFrameTimer = 0.f;
+        tweens = &game.tweens;
         currentBgFrame = 0;
-        if (!bgFrames.empty()) {
-            backgroundSprite.setTexture(bgFrames[0]);
-        }
+        showFrame(0);
+        tweens->cancel(frameTween);
+        if (bgAtlas.size() <= 1) return;
+        // A looping tween whose callback advances the frame.
+        frameTween = tweens->start({0.f, 1.f, GameConfig::BG_ANIMATION_DELAY, Ease::LINEAR, true, nullptr, [](void* context, int) {
+            AnimatedScreen& self = *static_cast<AnimatedScreen*>(context);
+            self.currentBgFrame = (self.currentBgFrame + 1) % self.bgAtlas.size();
+            self.showFrame(self.currentBgFrame);
+        }, this});
     }
 
-    void drawBackground(sf::RenderWindow& window) {
+    void onExit(Game& game) override { game.tweens.cancel(frameTween); }
+
+    void drawBackground(sf::RenderTarget& window) {
         const sf::Texture* tex = backgroundSprite.getTexture();
         if (tex && tex->getSize().x > 0) {
-            sf::Vector2f targetSize(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
-            sf::Vector2u texSize = tex->getSize();
-            float scaleX = targetSize.x / texSize.x;
-            float scaleY = targetSize.y / texSize.y;
-            float scale = std::min(scaleX, scaleY); 
-
-            backgroundSprite.setScale(scale, scale);
-            Utils::centerOrigin(backgroundSprite);
-            backgroundSprite.setPosition(targetSize.x / 2.0f, targetSize.y / 2.0f);
-
             window.draw(backgroundSprite);
         } else {
             window.clear(sf::Color(10, 0, 10)); 
@@ -568,6 +2038,48 @@ public:
     }
 };
 
+class LoadingScreen : public Screen {
+    sf::Text loadingText;
+    sf::RectangleShape barFrame, barFill;
+    AssetLoader& loader;
+public:
+    explicit LoadingScreen(AssetLoader& assetLoader) : loader(assetLoader) {
+        loadingText.setFont(ResourceManager::getFont(GameConfig::FONT_PATH_ARIBLK));
+        loadingText.setString("LOADING...");
+        loadingText.setCharacterSize(55);
+        loadingText.setFillColor(GameConfig::GOLD_COLOR);
+        loadingText.setOutlineColor(sf::Color::Black);
+        loadingText.setOutlineThickness(5);
+        Utils::centerOrigin(loadingText);
+
+        barFrame.setSize({600, 30});
+        barFrame.setFillColor({10, 10, 10, 200});
+        barFrame.setOutlineThickness(4);
+        barFrame.setOutlineColor(GameConfig::GOLD_COLOR);
+        Utils::centerOrigin(barFrame);
+        barFill.setFillColor(GameConfig::GOLD_COLOR);
+    }
+
+    void onResize(unsigned int width, unsigned int height) override {
+        loadingText.setPosition(width / 2.0f, height * 0.4f);
+        barFrame.setPosition(width / 2.0f, height * 0.55f);
+        barFill.setPosition(barFrame.getPosition() - barFrame.getOrigin());
+    }
+
+    void handleEvent(sf::Event& event, Game& game) override {}
+
+    void update(sf::Time dt, Game& game) override {
+        barFill.setSize({barFrame.getSize().x * loader.progress(), barFrame.getSize().y});
+    }
+
+    void draw(sf::RenderTarget& window) override {
+        window.clear(sf::Color(10, 0, 10));
+        window.draw(loadingText);
+        window.draw(barFrame);
+        window.draw(barFill);
+    }
+};
+
 class MenuScreen : public AnimatedScreen {
     sf::Text titleText, pressEnterText;
 public:
@@ -592,22 +2104,24 @@ public:
     void onResize(unsigned int width, unsigned int height) override {
         titleText.setPosition(width / 2.0f, height * 0.4f);
         pressEnterText.setPosition(width / 2.0f, height * 0.65f);
+        layer.invalidate();
     }
 
     void handleEvent(sf::Event& event, Game& game) override {
         if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Enter) {
+            game.audio.play(SoundId::CONFIRM);
             game.changeScreen(GameStateID::NAME_INPUT);
         }
     }
 
-    void update(sf::Time dt, Game& game) override {
-        updateAnimation(dt);
-    }
+    void update(sf::Time dt, Game& game) override {}
 
-    void draw(sf::RenderWindow& window) override {
+    void draw(sf::RenderTarget& window) override {
         drawBackground(window);
-        window.draw(titleText);
-        window.draw(pressEnterText);
+        layer.draw(window, [this](sf::RenderTarget& target) {
+            target.draw(titleText);
+            target.draw(pressEnterText);
+        });
     }
 };
 
@@ -616,7 +2130,17 @@ class NameInputScreen : public AnimatedScreen {
     sf::RectangleShape inputBox;
     std::string& playerNameRef;
     bool isActive = true, showCursor = true;
-    sf::Clock cursorBlinkClock;
+    TweenSystem::Handle blinkTween;
+
+    // Shows the cursor and restarts its blink: a looping tween that toggles it.
+    void restartBlink() {
+        showCursor = true;
+        tweens->cancel(blinkTween);
+        blinkTween = tweens->start({0.f, 1.f, GameConfig::CURSOR_BLINK_INTERVAL, Ease::LINEAR, true, nullptr, [](void* context, int) {
+            NameInputScreen& self = *static_cast<NameInputScreen*>(context);
+            self.showCursor = !self.showCursor;
+        }, this});
+    }
 public:
     NameInputScreen(std::string& playerNameOutput)
     : AnimatedScreen("menu_bg", GameConfig::MENU_BG_PATH_PREFIX, GameConfig::MENU_BG_FRAME_COUNT), playerNameRef(playerNameOutput) {
@@ -658,16 +2182,24 @@ public:
         AnimatedScreen::onEnter(game);
         playerNameRef.clear();
         nameDisplay.setString("");
+        layer.invalidate();
         isActive = true;
-        showCursor = true;
-        cursorBlinkClock.restart();
+        restartBlink();
+    }
+
+    void onExit(Game& game) override {
+        AnimatedScreen::onExit(game);
+        game.tweens.cancel(blinkTween);
     }
 
+    ~NameInputScreen() override { if (tweens) tweens->cancel(blinkTween); }
+
     void onResize(unsigned int width, unsigned int height) override {
         promptText.setPosition(width / 2.0f, height * 0.3f);
         inputBox.setPosition(width / 2.0f, height * 0.5f);
         nameDisplay.setPosition(inputBox.getPosition().x - inputBox.getSize().x / 2.f + 15, inputBox.getPosition().y - inputBox.getSize().y / 2.f + 10);
         continueText.setPosition(width / 2.0f, height * 0.75f);
+        layer.invalidate();
     }
 
     void handleEvent(sf::Event& event, Game& game) override {
@@ -682,13 +2214,16 @@ public:
                 }
             }
             nameDisplay.setString(playerNameRef);
-            showCursor = true;
-            cursorBlinkClock.restart();
+            layer.invalidate();
+            game.audio.play(SoundId::TYPE);
+            restartBlink();
         }
 
         if (event.type == sf::Event::KeyPressed) {
             if (event.key.code == sf::Keyboard::Enter && !playerNameRef.empty()) {
+                game.audio.play(SoundId::CONFIRM);
                 isActive = false;
+                game.tweens.cancel(blinkTween);
                 game.startGameplay();
             } else if (event.key.code == sf::Keyboard::Escape) {
                 game.changeScreen(GameStateID::MENU);
@@ -696,36 +2231,29 @@ public:
         }
     }
 
-    void update(sf::Time dt, Game& game) override {
-        updateAnimation(dt);
-        
-        if (isActive && cursorBlinkClock.getElapsedTime().asSeconds() > 0.5f) {
-            showCursor = !showCursor;
-            cursorBlinkClock.restart();
-        }
-    }
+    void update(sf::Time dt, Game& game) override {}
 
-    void draw(sf::RenderWindow& window) override {
+    void draw(sf::RenderTarget& window) override {
         drawBackground(window);
-        window.draw(promptText);
-        window.draw(inputBox);
-        window.draw(nameDisplay);
+        layer.draw(window, [this](sf::RenderTarget& target) {
+            target.draw(promptText);
+            target.draw(inputBox);
+            target.draw(nameDisplay);
+            if (!playerNameRef.empty()) target.draw(continueText);
+        });
         if (isActive && showCursor) {
             cursorText.setPosition(nameDisplay.getPosition().x + nameDisplay.getGlobalBounds().width + 5, nameDisplay.getPosition().y);
             window.draw(cursorText);
         }
-        if (!playerNameRef.empty()) {
-            window.draw(continueText);
-        }
     }
 };
 
 class GameOverScreen : public Screen {
     sf::Text gameOverText, reasonText, continueText;
-    sf::Sprite background;
+    FittedBackground background;
     sf::RectangleShape overlay;
 public:
-    GameOverScreen(const std::string& reason, std::string finalBgId) {
+    GameOverScreen() {
         sf::Font& font = ResourceManager::getFont(GameConfig::FONT_PATH_ARIBLK);
 
         gameOverText.setFont(font);
@@ -736,7 +2264,6 @@ public:
         Utils::centerOrigin(gameOverText);
 
         reasonText.setFont(font);
-        reasonText.setString(reason);
         reasonText.setCharacterSize(50);
         reasonText.setFillColor(GameConfig::OFF_WHITE_COLOR);
         reasonText.setOutlineColor(sf::Color::Black);
@@ -751,12 +2278,18 @@ public:
         continueText.setOutlineThickness(4);
         Utils::centerOrigin(continueText);
 
-        background.setTexture(ResourceManager::getTexture(finalBgId));
         overlay.setFillColor(sf::Color(0, 0, 0, 180));
+    }
 
-        bool win = reason.find("VICTORIOUS") != std::string::npos;
+    // Sets up the screen for the session that just ended; called before
+    // changing to it, and laid out by the onResize() that follows.
+    void show(Outcome outcome, TextureHandle finalBackground) {
+        reasonText.setString(outcomeReason(outcome));
+        background.setTexture(finalBackground);
+
+        bool win = outcome == Outcome::VICTORY;
         gameOverText.setFillColor(win ? GameConfig::WIN_GREEN_COLOR : GameConfig::ALERT_RED_COLOR);
-        if(win) gameOverText.setString("VICTORY!");
+        gameOverText.setString(win ? "VICTORY!" : "GAME OVER");
         Utils::centerOrigin(gameOverText);
     }
 
@@ -775,6 +2308,7 @@ public:
 
     void handleEvent(sf::Event& event, Game& game) override {
         if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Enter) {
+            game.audio.play(SoundId::CONFIRM);
             game.changeScreen(GameStateID::MENU);
         }
     }
@@ -782,22 +2316,8 @@ public:
     void update(sf::Time dt, Game& game) override {
     }
 
-    void draw(sf::RenderWindow& window) override {
-        const sf::Texture* tex = background.getTexture();
-        if (tex && tex->getSize().x > 0) {
-            sf::Vector2f targetSize((float)GameConfig::WINDOW_WIDTH, (float)GameConfig::WINDOW_HEIGHT);
-            sf::Vector2u texSize = tex->getSize();
-            float scaleX = targetSize.x / texSize.x;
-            float scaleY = targetSize.y / texSize.y;
-            float scale = std::min(scaleX, scaleY);
-            background.setScale(scale, scale);
-            Utils::centerOrigin(background);
-            background.setPosition(targetSize.x / 2.0f, targetSize.y / 2.0f);
-            window.draw(background);
-        } else {
-            window.clear(sf::Color(10, 0, 10));
-        }
-
+    void draw(sf::RenderTarget& window) override {
+        background.draw(window);
         window.draw(overlay);
         window.draw(gameOverText);
         window.draw(reasonText);
@@ -809,52 +2329,21 @@ public:
 // 3. GAMEPLAY SCREEN (The Bridge)
 // =================================================================
 
-class GamePlayScreen : public Screen {
+// --- Gameplay HUD Text ---
+// The gameplay screen's texts and their refresh from the session, apart
+// from the panels, background and layout around them, so bench.cpp can
+// time the same refresh the game runs.
+class HudText {
 private:
-    enum class InteractionState { EXPLORING, COMBAT, CHOICE, MESSAGE };
-    InteractionState currentState = InteractionState::EXPLORING;
+    unsigned int dirty = Dirty::ALL;
+    std::string inventoryString;
 
-    enum class GpTransitionState { NONE, FADING_OUT, FADING_IN };
-    GpTransitionState transitionState = GpTransitionState::NONE;
-    sf::RectangleShape transitionOverlay;
-    sf::Clock transitionClock;
-    std::function<void()> onTransitionComplete;
-
-    Game& game;
-    sf::Sprite background;
-    sf::RectangleShape uiPanel, messagePanel;
+public:
     sf::Text roomNameText, roomDescText, entityDescText, playerStatsText, actionPromptsText, interactionText, recentActionsTitle, recentActionsText;
+    ActionLog actionLog;
+    float messageWidth = GameConfig::WINDOW_WIDTH * 0.7f - 40.f; // Wrap width of interactionText.
 
-    sf::RectangleShape damageFlash;
-    sf::Clock flashClock;
-    float flashDuration = 0.f;
-
-    std::string message;
-    std::deque<std::string> actionsLog;
-    const size_t MAX_LOG_SIZE = 4;
-    
-    bool m_isNewRoomEntry = true;
-
-
-    void drawBackground(sf::RenderWindow& window) {
-        const sf::Texture* tex = background.getTexture();
-        if (tex && tex->getSize().x > 0) {
-            sf::Vector2f targetSize((float)GameConfig::WINDOW_WIDTH, (float)GameConfig::WINDOW_HEIGHT);
-            sf::Vector2u texSize = tex->getSize();
-            float scaleX = targetSize.x / texSize.x;
-            float scaleY = targetSize.y / texSize.y;
-            float scale = std::min(scaleX, scaleY);
-            background.setScale(scale, scale);
-            Utils::centerOrigin(background);
-            background.setPosition(targetSize.x / 2.0f, targetSize.y / 2.0f);
-            window.draw(background);
-        } else {
-            window.clear(sf::Color(10, 0, 10));
-        }
-    }
-
-public:
-    explicit GamePlayScreen(Game& g) : game(g) {
+    HudText() {
         sf::Font& font = ResourceManager::getFont(GameConfig::FONT_PATH_ARIBLK);
 
         auto styleText = [&](sf::Text& text, const sf::Color& color, int size, int outline) {
@@ -885,7 +2374,119 @@ public:
 
         styleText(interactionText, GameConfig::OFF_WHITE_COLOR, 32, 4);
         interactionText.setLineSpacing(1.2f);
+    }
+
+    void invalidate(unsigned int flags) { dirty |= flags; }
+    // Empties the log and marks everything stale, for a new session.
+    void reset() {
+        actionLog.clear();
+        dirty = Dirty::ALL;
+    }
+    void addAction(const char* format, const std::string& arg) {
+        if (actionLog.write(format, arg)) dirty |= Dirty::LOG;
+    }
+
+    // Brings the texts up to date with the session's dirty flags. Returns
+    // the flags it refreshed, Dirty::NONE when nothing had changed.
+    unsigned int refresh(GameSession& session) {
+        const Player& player = session.getPlayer();
+        Dungeon& dungeon = session.getDungeon();
+        Room* room = dungeon.getCurrentRoom();
+        if (!room) return Dirty::NONE;
+
+        dirty |= session.consumeDirty();
+        if (dirty == Dirty::NONE) return Dirty::NONE;
+
+        if (dirty & Dirty::ROOM) {
+            roomNameText.setString(dungeon.nameOf(*room));
+            
+            TextLayout::setWrappedString(roomDescText, dungeon.descriptionOf(*room), GameConfig::WINDOW_WIDTH - 60);
+            roomDescText.setPosition(30.f, 100.f);
+
+            entityDescText.setString("");
+            if(room->entity) {
+                entityDescText.setString(room->entity->getDescription());
+                if(entityCast<Enemy>(room->entity)) {
+                    entityDescText.setFillColor(GameConfig::ALERT_RED_COLOR);
+                } else {
+                    entityDescText.setFillColor(GameConfig::GOLD_COLOR);
+                }
+            }
+            entityDescText.setPosition(30.f, roomDescText.getPosition().y + roomDescText.getGlobalBounds().height + 40.f);
+        }
+        
+        if (dirty & Dirty::INVENTORY) {
+            inventoryString = player.getInventory().getSortedString();
+        }
+        // HUD strings are assembled in the frame arena; only sf::Text's own
+        // copy touches the heap.
+        if (dirty & (Dirty::STATS | Dirty::INVENTORY)) {
+            FrameString stats(256);
+            stats << "Player: " << player.getName() << "\n"
+                  << "Health: " << player.getHealth() << " / 100\n"
+                  << "Moves Left: " << player.getMoves() << "\n"
+                  << "Inventory: " << inventoryString;
+            playerStatsText.setString(stats.c_str());
+        }
+
+        if (dirty & Dirty::LOG) {
+            recentActionsText.setString(actionLog.text());
+        }
+
+        if (dirty & Dirty::INTERACTION) {
+            FrameString prompt(128);
+            switch (session.getState()) {
+                case InteractionState::EXPLORING:
+                    {
+                        auto addPrompt = [&prompt](const char* line) { prompt << (prompt.empty() ? "" : "\n") << line; };
+                        bool inSwordRoomWithSword = session.inSwordRoomWithSword();
+
+                        if (inSwordRoomWithSword) addPrompt("[C] Collect Sword");
+                        if (dungeon.canMoveForward()) addPrompt("[F] Forward");
+                        if (dungeon.canMoveBack()) addPrompt("[B] Backtrack");
+                        if (!inSwordRoomWithSword) addPrompt("[Q] Quit");
+                    }
+                    break;
+                case InteractionState::COMBAT: prompt << "[F] Fight!\n[R] Attempt to Run"; break;
+                case InteractionState::CHOICE: prompt << "[1] Take Golden Key\n[2] Take Health Potion"; break;
+                case InteractionState::MESSAGE:
+                    TextLayout::setWrappedString(interactionText, session.getMessage(), messageWidth);
+                    interactionText.setFillColor(GameConfig::OFF_WHITE_COLOR);
+                    prompt << "[Enter] Continue";
+                    break;
+            }
+            actionPromptsText.setString(prompt.c_str());
+
+            sf::FloatRect promptBounds = actionPromptsText.getLocalBounds();
+            actionPromptsText.setOrigin(promptBounds.left + promptBounds.width, promptBounds.top);
+        }
+
+        unsigned int refreshed = dirty;
+        dirty = Dirty::NONE;
+        return refreshed;
+    }
+};
+
+class GamePlayScreen : public Screen {
+private:
+    ScreenFade roomFade; // Played around every non-instant action.
+
+    Game& game;
+    FittedBackground background;
+    sf::RectangleShape uiPanel, messagePanel;
+    HudText hud;
+
+    TweenSystem::Handle flashTween; // Flash alpha.
+
+    // The HUD text in three layers: over the background, on the
+    // bottom panel and in the message box.
+    TextBatch sceneText, panelText, messageText;
+    LayerCache layer; // Everything above; the flash and fade are post effects.
+
+    void invalidate(unsigned int flags) { hud.invalidate(flags); }
 
+public:
+    explicit GamePlayScreen(Game& g) : roomFade(g.tweens, GameConfig::GAMEPLAY_TRANSITION_DURATION), game(g) {
         uiPanel.setFillColor({0, 0, 0, 200});
         uiPanel.setOutlineColor(GameConfig::GOLD_COLOR);
         uiPanel.setOutlineThickness(3.f);
@@ -894,18 +2495,23 @@ public:
         messagePanel.setOutlineColor(GameConfig::ALERT_RED_COLOR);
         messagePanel.setOutlineThickness(3.f);
 
-        transitionOverlay.setFillColor(sf::Color(0,0,0,0));
-
-        damageFlash.setFillColor(sf::Color::Transparent);
-        damageFlash.setOutlineColor(sf::Color::Transparent);
-        damageFlash.setOutlineThickness(15);
+        sceneText.add(hud.roomNameText);
+        sceneText.add(hud.roomDescText);
+        sceneText.add(hud.entityDescText);
+        panelText.add(hud.playerStatsText);
+        panelText.add(hud.recentActionsTitle);
+        panelText.add(hud.recentActionsText);
+        panelText.add(hud.actionPromptsText);
+        messageText.add(hud.interactionText);
     }
 
     void onEnter(Game& gameRef) override {
-        actionsLog.clear();
-        m_isNewRoomEntry = true;
-        addAction("Your adventure begins...");
-        checkRoomState();
+        // The screen is reused across games; drop whatever the last one left.
+        roomFade.reset();
+        game.tweens.cancel(flashTween);
+        hud.reset();
+        game.session->onLog = [this](LogLine line, const std::string& arg) { addAction(logTemplate(line), arg); };
+        game.session->start();
         onResize(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
     }
 
@@ -913,457 +2519,478 @@ public:
         uiPanel.setSize({(float)width, 200.f});
         uiPanel.setPosition(0, height - 200.f);
         
-        roomNameText.setPosition(30.f, 30.f);
-        roomDescText.setPosition(30.f, 100.f);
+        hud.roomNameText.setPosition(30.f, 30.f);
+        hud.roomDescText.setPosition(30.f, 100.f);
 
         float panelX = uiPanel.getPosition().x;
         float panelY = uiPanel.getPosition().y;
         float panelW = uiPanel.getSize().x;
         
-        playerStatsText.setPosition(panelX + 30, panelY + 20);
-        recentActionsTitle.setPosition(panelX + panelW / 2.f, panelY + 25);
-        recentActionsText.setPosition(panelX + panelW / 2.f - 200, panelY + 60);
+        hud.playerStatsText.setPosition(panelX + 30, panelY + 20);
+        hud.recentActionsTitle.setPosition(panelX + panelW / 2.f, panelY + 25);
+        hud.recentActionsText.setPosition(panelX + panelW / 2.f - 200, panelY + 60);
 
         messagePanel.setSize({width * 0.7f, height * 0.5f});
+        hud.messageWidth = messagePanel.getSize().x - 40;
         Utils::centerOrigin(messagePanel);
         messagePanel.setPosition(width/2.f, height/2.f);
-        interactionText.setPosition(messagePanel.getPosition().x - messagePanel.getOrigin().x + 20, messagePanel.getPosition().y - messagePanel.getOrigin().y + 20);
+        hud.interactionText.setPosition(messagePanel.getPosition().x - messagePanel.getOrigin().x + 20, messagePanel.getPosition().y - messagePanel.getOrigin().y + 20);
 
-        transitionOverlay.setSize({(float)width, (float)height});
-        damageFlash.setSize({(float)width, (float)height});
+        invalidate(Dirty::ALL);
         updateUI();
     }
 
-    void startTransition(std::function<void()> callback) {
-        if (transitionState == GpTransitionState::NONE) {
-            transitionState = GpTransitionState::FADING_OUT;
-            onTransitionComplete = std::move(callback);
-            transitionClock.restart();
-        }
+    ~GamePlayScreen() override { game.tweens.cancel(flashTween); }
+
+    // Fades out, applies the action at full black, then fades back in
+    // unless the outcome leaves the screen.
+    void startTransition(Action action) {
+        if (roomFade.isActive()) return;
+        roomFade.fadeOut([](void* context, int arg) {
+            GamePlayScreen& self = *static_cast<GamePlayScreen*>(context);
+            self.performAction(static_cast<Action>(arg));
+            if (!self.handleOutcome()) self.roomFade.fadeIn();
+        }, this, static_cast<int>(action));
     }
 
-    void addAction(const std::string& action) {
-        if (action.empty() || (!actionsLog.empty() && action == actionsLog.front())) {
-            return;
-        }
-        actionsLog.push_front(action);
-        if (actionsLog.size() > MAX_LOG_SIZE) {
-            actionsLog.pop_back();
-        }
+    void addAction(const char* format, const std::string& arg = std::string()) {
+        hud.addAction(format, arg);
     }
 
     void handleEvent(sf::Event& event, Game& gameRef) override {
         if (event.type != sf::Event::KeyPressed) return;
-        if (transitionState != GpTransitionState::NONE) return;
-
-        switch (currentState) {
-            case InteractionState::EXPLORING:
-                if (event.key.code == sf::Keyboard::F) {
-                    if (game.playerLogic->getMoves() <= 0) {
-                        triggerGameOver("You have run out of moves.");
-                        break;
-                    }
-                    if (game.dungeonLogic->canMoveForward()){
-                        startTransition([this](){ m_isNewRoomEntry = true; game.dungeonLogic->moveForward(); });
-                    }
-                }
-                else if (event.key.code == sf::Keyboard::B) {
-                    if (game.playerLogic->getMoves() <= 0) {
-                        triggerGameOver("You have run out of moves.");
-                        break;
-                    }
-                    if(game.dungeonLogic->canMoveBack()) {
-                       startTransition([this](){ m_isNewRoomEntry = true; game.dungeonLogic->moveBack(); });
-                    }
-                }
-                else if (event.key.code == sf::Keyboard::C) {
-                    Room* room = game.dungeonLogic->getCurrentRoom();
-                    if (room && room->entity && dynamic_cast<Weapon*>(room->entity.get()) && room->name == "Chamber of the Cursed Blades") {
-                        startTransition([this, room]() {
-                            game.playerLogic->collectItem("Sword");
-                            addAction("You collected the Sword.");
-                            room->description = "You grasp the sword. A surge of ultimate power floods your veins.";
-                            room->entity.reset(nullptr); 
-                            currentState = InteractionState::EXPLORING;
-                        });
-                    }
-                }
-                else if (event.key.code == sf::Keyboard::Q) {
-                    Room* room = game.dungeonLogic->getCurrentRoom();
-                    bool inSwordRoomWithSword = room && room->entity && dynamic_cast<Weapon*>(room->entity.get()) && room->name == "Chamber of the Cursed Blades";
-                    if (!inSwordRoomWithSword) {
-                         game.changeScreen(GameStateID::MENU);
-                    }
-                }
-                break;
-            case InteractionState::COMBAT:
-                if (event.key.code == sf::Keyboard::F) { startTransition([this](){ handleCombat(); }); }
-                else if (event.key.code == sf::Keyboard::R) { addAction("Fled in terror!"); triggerGameOver("You fled in terror!"); }
-                break;
-            case InteractionState::CHOICE:
-                if (event.key.code == sf::Keyboard::Num1 || event.key.code == sf::Keyboard::Numpad1) { startTransition([this](){ handleChoice(1); }); }
-                else if (event.key.code == sf::Keyboard::Num2 || event.key.code == sf::Keyboard::Numpad2) { startTransition([this](){ handleChoice(2); }); }
-                break;
-            case InteractionState::MESSAGE:
-                if (event.key.code == sf::Keyboard::Enter) { startTransition([this](){ currentState = InteractionState::EXPLORING; }); }
-                break;
+        if (roomFade.isActive()) return;
+
+        // Keys go through the core's bindings (actionForKey), shared with headless.
+        char key;
+        switch (event.key.code) {
+            case sf::Keyboard::F: key = 'F'; break;
+            case sf::Keyboard::B: key = 'B'; break;
+            case sf::Keyboard::C: key = 'C'; break;
+            case sf::Keyboard::Q: key = 'Q'; break;
+            case sf::Keyboard::R: key = 'R'; break;
+            case sf::Keyboard::Num1:
+            case sf::Keyboard::Numpad1: key = '1'; break;
+            case sf::Keyboard::Num2:
+            case sf::Keyboard::Numpad2: key = '2'; break;
+            case sf::Keyboard::Enter: key = 'E'; break;
+            case sf::Keyboard::F6: saveGame(); return;
+            case sf::Keyboard::F9: loadGame(); return;
+            default: return;
+        }
+        Action action;
+        if (!actionForKey(game.session->getState(), key, action) || !game.session->canApply(action)) return;
+
+        if (game.session->isInstant(action)) {
+            game.session->apply(action);
+            handleOutcome();
+        } else {
+            startTransition(action);
         }
     }
 
-    void triggerGameOver(const std::string& reason) {
-        std::string bg = game.dungeonLogic->getCurrentRoom() ? game.dungeonLogic->getCurrentRoom()->backgroundID : "dungeon.png";
-        game.screens[GameStateID::GAME_OVER] = std::make_unique<GameOverScreen>(reason, bg);
-        game.changeScreen(GameStateID::GAME_OVER);
+    void saveGame() {
+        std::string snapshot;
+        game.session->saveSnapshot(snapshot);
+        game.saveWriter.save(GameConfig::SAVE_PATH, std::move(snapshot));
     }
 
-    void checkRoomState() {
-        Room* room = game.dungeonLogic->getCurrentRoom();
-        if (!room) return;
-        
-        if (m_isNewRoomEntry) {
-            addAction("Entered The " + room->name);
-            m_isNewRoomEntry = false;
-        }
-
-
-        if (room->isFinalDoor) {
-             if (game.playerLogic->hasItem("Golden Key") && game.playerLogic->isFinalBossDefeated()) {
-                 triggerGameOver("You used the Golden key and escaped. You are VICTORIOUS!");
-                 return;
-             } else if (game.playerLogic->hasItem("Golden Key")) {
-                 triggerGameOver("The final door is locked tight. The boss must be defeated!");
-             }
-             else {
-                 triggerGameOver("The final door is locked. You needed the Golden Key.");
-             }
-        }
-        else if (room->entity) {
-            if (dynamic_cast<Weapon*>(room->entity.get()) && room->name == "Chamber of the Cursed Blades") {
-                currentState = InteractionState::EXPLORING;
-            }
-            else if (dynamic_cast<Enemy*>(room->entity.get())) {
-                currentState = InteractionState::COMBAT;
-            }
-            else { 
-                handleItemInteraction();
-            }
+    void loadGame() {
+        std::ifstream in(GameConfig::SAVE_PATH, std::ios::binary);
+        std::stringstream bytes;
+        bytes << in.rdbuf();
+        std::string error = "no save file";
+        if (!in || !game.session->restoreSnapshot(bytes.str(), error)) {
+            addAction("Could not load: %", error);
+            return;
+        }
+        game.tweens.cancel(flashTween);
+        invalidate(Dirty::ALL);
+        addAction("Game loaded.");
+        handleOutcome();
+    }
+
+    void performAction(Action action) {
+        game.session->apply(action);
+        switch (action) {
+            case Action::FIGHT:
+                game.audio.play(SoundId::HIT);
+                game.triggerScreenShake(0.3f, 20.f);
+                game.tweens.cancel(flashTween);
+                flashTween = game.tweens.start({180.f, 0.f, 0.25f});
+                break;
+            case Action::FORWARD:
+            case Action::BACK: game.audio.play(SoundId::STEP); break;
+            case Action::COLLECT:
+            case Action::CHOOSE_KEY:
+            case Action::CHOOSE_POTION: game.audio.play(SoundId::PICKUP); break;
+            default: break;
         }
-        else if (room->isChoiceRoom) { currentState = InteractionState::CHOICE; }
-        else { currentState = InteractionState::EXPLORING; }
-        updateUI();
     }
 
-    void handleItemInteraction() {
-        Room* room = game.dungeonLogic->getCurrentRoom();
-        if (!room || !room->entity) return;
-        Item* item = dynamic_cast<Item*>(room->entity.get());
-        if (!item) return;
-
-        std::string result;
-        item->interact(*game.playerLogic, result);
-        addAction(result);
-        room->description = result;
-        room->entity.reset(nullptr);
-
-        currentState = InteractionState::EXPLORING;
-        updateUI();
+    // Leaves the gameplay screen once the session has finished. Returns true if it did.
+    bool handleOutcome() {
+        Outcome outcome = game.session->getOutcome();
+        if (outcome == Outcome::NONE) return false;
+        game.lastOutcome = outcome;
+        if (outcome != Outcome::QUIT) game.audio.play(outcome == Outcome::VICTORY ? SoundId::VICTORY : SoundId::DEFEAT);
+        if (outcome == Outcome::QUIT) game.changeScreen(GameStateID::MENU);
+        else triggerGameOver(outcome);
+        return true;
     }
 
-    void handleCombat() {
-        Room* room = game.dungeonLogic->getCurrentRoom();
-        if (!room || !room->entity) return;
-        Enemy* enemy = dynamic_cast<Enemy*>(room->entity.get());
-        if(!enemy) return;
+    void triggerGameOver(Outcome outcome) {
+        Dungeon& dungeon = game.session->getDungeon();
+        Room* room = dungeon.getCurrentRoom();
+        TextureHandle bg = room ? backgroundOf(dungeon, *room) : ResourceManager::findTextureHandle("dungeon.png");
+        game.screens.as<GameOverScreen>(GameStateID::GAME_OVER).show(outcome, bg);
+        game.changeScreen(GameStateID::GAME_OVER);
+    }
 
-        addAction("Fought the " + enemy->getName());
-        int effectiveDamage = enemy->getDamage();
-        message = "";
+    void updateUI() {
+        GameSession& session = *game.session;
+        unsigned int refreshed = hud.refresh(session);
+        if (refreshed == Dirty::NONE) return;
 
-        if (dynamic_cast<BossEnemy*>(enemy)) {
-            if(game.playerLogic->hasItem("Sword")) {
-                 message = "Your Sword glows, weakening the boss!\n";
-                 effectiveDamage = 50;
-            } else {
-                 message = "You are unarmed against the mighty boss!\n";
-            }
+        if (refreshed & Dirty::ROOM) background.setTexture(backgroundOf(session.getDungeon(), *session.getDungeon().getCurrentRoom()));
+        if (refreshed & Dirty::INTERACTION) {
+            hud.actionPromptsText.setPosition(uiPanel.getPosition().x + uiPanel.getSize().x - 30, uiPanel.getPosition().y + 25);
         }
 
-        std::string damageResult = game.playerLogic->takeDamage(effectiveDamage);
-        message += damageResult;
-
-        game.triggerScreenShake(0.3f, 20.f);
-        flashDuration = 0.25f;
-        flashClock.restart();
-
-        if (game.playerLogic->getHealth() <= 0) {
-            addAction("You were slain by the " + enemy->getName());
-            triggerGameOver("You have died in combat.");
-            return;
-        }
-        
-        std::string enemyName = enemy->getName();
-        addAction("Defeated the " + enemyName);
-        if (dynamic_cast<BossEnemy*>(enemy)) {
-            game.playerLogic->setBossDefeated(true);
-            addAction("The final boss is defeated!");
-        }
-        
-        room->description = "You defeated the " + enemyName + ". The way is clear. (You took " + std::to_string(effectiveDamage) + " damage)";
+        sceneText.invalidate();
+        panelText.invalidate();
+        messageText.invalidate();
+        layer.invalidate();
+        game.requestRedraw();
+    }
 
-        room->entity.reset(nullptr);
-        currentState = InteractionState::MESSAGE;
+    void update(sf::Time dt, Game& gameRef) override {
+        bool saved;
+        while (game.saveWriter.pollFinished(saved)) addAction(saved ? "Game saved." : "Save failed.");
+        updateUI();
     }
 
-    void handleChoice(int choice) {
-        Room* room = game.dungeonLogic->getCurrentRoom();
-        if (!room || !room->isChoiceRoom) return;
-        
-        if (choice == 1) {
-            game.playerLogic->collectItem("Golden Key");
-            addAction("You took the Golden Key.");
-            room->description = "You took the Golden Key.";
-        } else {
-            game.playerLogic->heal(100);
-            addAction("You drank the Health Potion.");
-            room->description = "You drank the Health Potion.";
+    // Sampled per rendered frame with the render lead, so fades stay smooth
+    // whatever the display's refresh rate.
+    void addEffects(PostEffects& effects) override {
+        if (game.tweens.isActive(flashTween)) {
+            float alpha = game.tweens.sample(flashTween, 0.f);
+            effects.flash = sf::Color(GameConfig::LIGHT_RED_FLASH.r, GameConfig::LIGHT_RED_FLASH.g, GameConfig::LIGHT_RED_FLASH.b, static_cast<sf::Uint8>(alpha));
+            effects.vignette = alpha / 255.f * GameConfig::DAMAGE_VIGNETTE;
         }
-        room->isChoiceRoom = false;
-        
-        currentState = InteractionState::EXPLORING;
+        if (roomFade.isActive()) effects.addFade(roomFade.alpha() / 255.f);
+    }
+
+    void draw(sf::RenderTarget& window) override {
+        layer.draw(window, [this](sf::RenderTarget& target) {
+            background.draw(target);
+            sceneText.draw(target);
+            target.draw(uiPanel);
+            panelText.draw(target);
+            if (game.session->getState() == InteractionState::MESSAGE) {
+                target.draw(messagePanel);
+                messageText.draw(target);
+            }
+        });
     }
+};
 
-    void updateUI() {
-        Room* room = game.dungeonLogic->getCurrentRoom();
-        if (!room) return;
+// =================================================================
+// 4. MAIN GAME & SETUP
+// =================================================================
 
-        sf::Texture& bgTex = ResourceManager::getTexture(room->backgroundID);
-        if (bgTex.getSize().x > 0) background.setTexture(bgTex, true);
+Game::Game(PacingMode pacingMode)
+    : window(sf::VideoMode(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT), "Dungeon Escape"),
+      mainView(sf::FloatRect(0, 0, GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT))
+{
+    setPacing(pacingMode);
+    postProcess.init(GameConfig::POST_PROCESS_SHADER);
+
+    // The font is needed by the loading screen itself; everything else decodes
+    // in the background. Menu frames go first so the menu is usable early.
+    // Room backgrounds beyond the entrance are prefetched as the player moves.
+    profilerOverlay.setFont(ResourceManager::getFont(GameConfig::FONT_PATH_ARIBLK));
+    audio.start(GameConfig::MUSIC_VOLUME);
+    audio.playMusic(screenMusic(GameStateID::LOADING), 0.f);
+    assetLoader.start();
+    assetLoader.queueAtlas("menu_bg", GameConfig::MENU_BG_PATH_PREFIX, GameConfig::MENU_BG_FRAME_COUNT);
+    assetLoader.queueTexture("dungeon.png");
+
+    screens.add(GameStateID::LOADING, std::make_unique<LoadingScreen>(assetLoader));
+
+    currentStateID = GameStateID::LOADING;
+    screens.get(currentStateID)->onEnter(*this);
+    handleResize(window.getSize().x, window.getSize().y);
+}
 
-        roomNameText.setString(room->name);
-        
-        roomDescText.setString(room->description);
+void Game::startGameplay() {
+    assetLoader.finish();
+    session = std::make_unique<GameSession>(playerName, 100, 10);
+    loadLevel(session->getDungeon());
+    session->getDungeon().onRoomChanged = [this](Dungeon& dungeon) { prefetchAround(dungeon); };
+    prefetchAround(session->getDungeon());
+    changeScreen(GameStateID::GAMEPLAY);
+}
 
-        Utils::wrapText(roomDescText, GameConfig::WINDOW_WIDTH - 60);
-        roomDescText.setPosition(30.f, 100.f);
+// The level is read when each game starts, so a recompiled .dgn is picked up
+// without rebuilding the game. Packed levels load straight from the mapping.
+void Game::loadLevel(Dungeon& dungeon) {
+    const std::string& path = GameConfig::DUNGEON_PATH;
+    if (AssetPack::assetSize(path) < 0) {
+        setupDungeon(dungeon);
+        return;
+    }
+    std::string error;
+    AssetPack::Blob blob;
+    bool loaded = AssetPack::find(path, blob) ? loadDungeon(dungeon, blob.data, blob.size, error) : loadDungeonFile(dungeon, path, error);
+    if (!loaded) {
+        std::cerr << "Could not load " << path << " (" << error << "), using the built-in dungeon." << std::endl;
+        setupDungeon(dungeon);
+    }
+}
 
-        entityDescText.setString("");
-        if(room->entity) {
-            entityDescText.setString(room->entity->getDescription());
-            if(dynamic_cast<Enemy*>(room->entity.get())) {
-                entityDescText.setFillColor(GameConfig::ALERT_RED_COLOR);
-            } else {
-                entityDescText.setFillColor(GameConfig::GOLD_COLOR);
+// Keeps the current room and its neighbours resident and starts loading any
+// that are not; everything further away becomes evictable.
+void Game::prefetchAround(Dungeon& dungeon) {
+    std::vector<TextureHandle> keep;
+    for (Room* room : {dungeon.getCurrentRoom(), dungeon.getPreviousRoom(), dungeon.getNextRoom()}) {
+        if (!room) continue;
+        keep.push_back(backgroundOf(dungeon, *room));
+        assetLoader.queueTexture(dungeon.backgroundOf(*room));
+    }
+    ResourceManager::retainTextures(keep);
+}
+
+// Fixed-step loop: wall time accumulates and is consumed in FIXED_TIMESTEP
+// updates, and whatever is left over becomes the render lead.
+void Game::run() {
+    const sf::Time step = sf::seconds(GameConfig::FIXED_TIMESTEP);
+    sf::Clock frameClock;
+    sf::Time accumulator;
+    while (window.isOpen()) {
+        Profiler::beginFrame();
+        FrameArena::reset();
+        accumulator += std::min(frameClock.restart(), sf::seconds(GameConfig::MAX_FRAME_TIME));
+        {
+            PROFILE_SCOPE("events");
+            processEvents();
+        }
+        {
+            PROFILE_SCOPE("update");
+            int steps = 0;
+            while (accumulator >= step && steps < GameConfig::MAX_STEPS_PER_FRAME) {
+                simulate(step);
+                accumulator -= step;
+                ++steps;
             }
+            if (steps == GameConfig::MAX_STEPS_PER_FRAME && accumulator >= step) accumulator = sf::Time::Zero;
         }
-        entityDescText.setPosition(30.f, roomDescText.getPosition().y + roomDescText.getGlobalBounds().height + 40.f);
-        
-        std::string fullStats = "Player: " + game.playerLogic->getName() + "\n" +
-                              "Health: " + std::to_string(game.playerLogic->getHealth()) + " / 100\n" +
-                              "Moves Left: " + std::to_string(game.playerLogic->getMoves()) + "\n" +
-                              "Inventory: " + game.playerLogic->getInventory().getSortedString();
-        playerStatsText.setString(fullStats);
-
-        std::stringstream log_ss;
-        for(const auto& action : actionsLog) {
-            log_ss << "- " << action << "\n";
-        }
-        recentActionsText.setString(log_ss.str());
-
-        std::string prompt;
-        switch (currentState) {
-            case InteractionState::EXPLORING:
-                {
-                    std::vector<std::string> prompts;
-                    Room* currentRoom = game.dungeonLogic->getCurrentRoom();
-                    bool inSwordRoomWithSword = currentRoom && currentRoom->entity && dynamic_cast<Weapon*>(currentRoom->entity.get()) && currentRoom->name == "Chamber of the Cursed Blades";
-
-                    if (inSwordRoomWithSword) {
-                        prompts.push_back("[C] Collect Sword");
-                    }
-                    
-                    if (game.dungeonLogic->canMoveForward()) prompts.push_back("[F] Forward");
-                    if (game.dungeonLogic->canMoveBack()) prompts.push_back("[B] Backtrack");
-                    if (!inSwordRoomWithSword) {
-                        prompts.push_back("[Q] Quit");
-                    }
-
-                    std::stringstream ss;
-                    for(size_t i = 0; i < prompts.size(); ++i) {
-                        ss << prompts[i] << (i == prompts.size() - 1 ? "" : "\n");
-                    }
-                    prompt = ss.str();
-                }
-                break;
-            case InteractionState::COMBAT: prompt = "[F] Fight!\n[R] Attempt to Run"; break;
-            case InteractionState::CHOICE: prompt = "[1] Take Golden Key\n[2] Take Health Potion"; break;
-            case InteractionState::MESSAGE:
-                interactionText.setString(message);
-                interactionText.setFillColor(GameConfig::OFF_WHITE_COLOR);
-                Utils::wrapText(interactionText, messagePanel.getSize().x - 40);
-                prompt = "[Enter] Continue";
-                break;
+        SimClock::setRenderLead(accumulator);
+        bool active = redrawRequested || isAnimating();
+        redrawRequested = false;
+        if (!powerSaving || active || redrawPending) {
+            render();
+            paceFrame();
         }
-        actionPromptsText.setString(prompt);
-
-        sf::FloatRect promptBounds = actionPromptsText.getLocalBounds();
-        actionPromptsText.setOrigin(promptBounds.left + promptBounds.width, promptBounds.top);
-        float panelX = uiPanel.getPosition().x;
-        float panelY = uiPanel.getPosition().y;
-        float panelW = uiPanel.getSize().x;
-        actionPromptsText.setPosition(panelX + panelW - 30, panelY + 25);
+        redrawPending = active;
+        if (powerSaving) throttle(frameClock, active);
+        Profiler::endFrame();
     }
+    if (inputMode == InputMode::RECORDING) {
+        inputLog.endTick = inputTick;
+        if (!inputLog.save(recordPath)) std::cerr << "Could not write recording: " << recordPath << std::endl;
+    }
+}
 
-    void update(sf::Time dt, Game& gameRef) override {
-        if (flashDuration > 0) {
-            float elapsed = flashClock.getElapsedTime().asSeconds();
-            if (elapsed < flashDuration) {
-                float progress = elapsed / flashDuration;
-                sf::Uint8 alpha = static_cast<sf::Uint8>(Utils::lerp(180.f, 0.f, progress));
-                damageFlash.setFillColor(sf::Color(GameConfig::LIGHT_RED_FLASH.r, GameConfig::LIGHT_RED_FLASH.g, GameConfig::LIGHT_RED_FLASH.b, alpha));
-                damageFlash.setOutlineColor(sf::Color(255, 255, 255, alpha));
-            } else {
-                flashDuration = 0;
-                damageFlash.setFillColor(sf::Color::Transparent);
-                damageFlash.setOutlineColor(sf::Color::Transparent);
-            }
-        }
+// Whether the picture changes with time alone: a tween (fades, shake,
+// flash, blinking cursor, menu frames), the loading bar or the profiler.
+bool Game::isAnimating() const {
+    return tweens.activeCount() > 0 || currentStateID == GameStateID::LOADING
+        || profilerOverlay.isVisible() || Profiler::isCapturing();
+}
 
-        if (transitionState != GpTransitionState::NONE) {
-            float t = Utils::clamp(transitionClock.getElapsedTime().asSeconds() / GameConfig::GAMEPLAY_TRANSITION_DURATION, 0.f, 1.f);
-            sf::Uint8 alpha = 0;
+// Power saving: sleeps off the rest of the period when the window is in the
+// background (a low tick rate) or nothing is animating (an input poll).
+// Updates keep running at that rate, so background saves and texture
+// uploads still complete; what they change asks for a redraw.
+void Game::throttle(const sf::Clock& frameClock, bool active) {
+    sf::Time period;
+    if (!focused) period = sf::seconds(1.f / GameConfig::BACKGROUND_TICK_RATE);
+    else if (!active) period = sf::seconds(GameConfig::IDLE_POLL_INTERVAL);
+    else return;
+    PROFILE_SCOPE("idle");
+    sf::Time elapsed = frameClock.getElapsedTime();
+    if (elapsed < period) sf::sleep(period - elapsed);
+}
 
-            if (transitionState == GpTransitionState::FADING_OUT) {
-                alpha = static_cast<sf::Uint8>(Utils::lerp(0.f, 255.f, t));
-                if (t >= 1.0f) {
-                    if(onTransitionComplete) {
-                        onTransitionComplete();
-                        onTransitionComplete = nullptr;
-                    }
-                    
-                    // MODIFIED: Check for game over due to running out of moves.
-                    if (game.playerLogic->getMoves() < 0) {
-                        triggerGameOver("You have run out of moves.");
-                        return;
-                    }
+void Game::simulate(sf::Time step) {
+    SimClock::advance(step);
+    update(step);
+    if (inputClockStarted) ++inputTick;
+}
 
-                    checkRoomState();
-                    transitionState = GpTransitionState::FADING_IN;
-                    transitionClock.restart();
-                }
-            } else { // FADING_IN
-                alpha = static_cast<sf::Uint8>(Utils::lerp(255.f, 0.f, t));
-                if (t >= 1.0f) {
-                    transitionState = GpTransitionState::NONE;
-                }
-            }
-            transitionOverlay.setFillColor(sf::Color(0, 0, 0, alpha));
-        }
+void Game::recordInput(const std::string& path) {
+    inputMode = InputMode::RECORDING;
+    recordPath = path;
+    inputLog = InputLog();
+    inputLog.seed = std::random_device{}();
+    rng.seed(inputLog.seed);
+}
 
-        updateUI();
+bool Game::loadReplay(const std::string& path) {
+    std::string error;
+    if (!inputLog.load(path, error)) {
+        std::cerr << "Could not load replay: " << error << std::endl;
+        return false;
     }
+    inputMode = InputMode::REPLAY;
+    rng.seed(inputLog.seed);
+    return true;
+}
 
-    void draw(sf::RenderWindow& window) override {
-        drawBackground(window);
-
-        window.draw(roomNameText);
-        window.draw(roomDescText);
-        if(!entityDescText.getString().isEmpty()) window.draw(entityDescText);
-
-        window.draw(uiPanel);
-        window.draw(playerStatsText);
-        window.draw(recentActionsTitle);
-        window.draw(recentActionsText);
-        window.draw(actionPromptsText);
-
-        if (currentState == InteractionState::MESSAGE) {
-            window.draw(messagePanel);
-            window.draw(interactionText);
+// Feeds a loaded recording back one fixed step per iteration, as fast as
+// the machine allows, with or without drawing. Prints the cost per tick
+// and the outcome; returns nonzero if it differs from `expectedOutcome`,
+// or with `checkAllocations`, if any steady gameplay tick allocated.
+int Game::runReplay(bool draw, const std::string& expectedOutcome, bool checkAllocations) {
+    typedef std::chrono::steady_clock Clock;
+    const sf::Time step = sf::seconds(GameConfig::FIXED_TIMESTEP);
+    setPacing(PacingMode::UNCAPPED);
+    window.setVisible(draw); // The window stays open for its GL context.
+    SimClock::setRenderLead(sf::Time::Zero);
+
+    double updateMs = 0, renderMs = 0, worstUpdateMs = 0, worstRenderMs = 0;
+    // Steady ticks: gameplay with no input and nothing animating. These
+    // should not touch the heap at all.
+    std::uint64_t steadyTicks = 0, allocatingTicks = 0, firstAllocatingTick = 0, firstAllocations = 0;
+    while (window.isOpen() && !(inputClockStarted && inputTick >= inputLog.endTick)) {
+        Profiler::beginFrame();
+        FrameArena::reset();
+        size_t cursorBefore = replayCursor;
+        bool animatingBefore = tweens.activeCount() > 0;
+        std::uint64_t allocationsBefore = allocationCounters().count;
+        {
+            PROFILE_SCOPE("events");
+            processEvents();
         }
-        if (flashDuration > 0) {
-            window.draw(damageFlash);
+        Clock::time_point start = Clock::now();
+        {
+            PROFILE_SCOPE("update");
+            simulate(step);
         }
-        if (transitionState != GpTransitionState::NONE) {
-            window.draw(transitionOverlay);
+        Clock::time_point updated = Clock::now();
+        if (draw) render();
+        Clock::time_point rendered = Clock::now();
+        Profiler::endFrame();
+
+        std::uint64_t allocations = allocationCounters().count - allocationsBefore;
+        if (currentStateID == GameStateID::GAMEPLAY && replayCursor == cursorBefore && !animatingBefore && tweens.activeCount() == 0) {
+            ++steadyTicks;
+            if (allocations > 0 && allocatingTicks++ == 0) {
+                firstAllocatingTick = inputTick;
+                firstAllocations = allocations;
+            }
         }
+
+        if (!inputClockStarted) continue; // Still loading; not part of the benchmark.
+        double u = std::chrono::duration<double, std::milli>(updated - start).count();
+        double r = std::chrono::duration<double, std::milli>(rendered - updated).count();
+        updateMs += u;
+        renderMs += r;
+        worstUpdateMs = std::max(worstUpdateMs, u);
+        worstRenderMs = std::max(worstRenderMs, r);
+    }
+    if (!window.isOpen()) {
+        std::cerr << "Replay interrupted at tick " << inputTick << " of " << inputLog.endTick << std::endl;
+        return 1;
     }
-};
 
-// =================================================================
-// 4. MAIN GAME & SETUP
-// =================================================================
+    double ticks = static_cast<double>(std::max<std::uint64_t>(inputTick, 1));
+    std::cout << "Replayed " << inputTick << " ticks (" << inputLog.entries.size() << " events)" << std::endl;
+    std::cout << "  update: " << updateMs / ticks << " ms/tick, worst " << worstUpdateMs << " ms" << std::endl;
+    if (draw) std::cout << "  render: " << renderMs / ticks << " ms/tick, worst " << worstRenderMs << " ms" << std::endl;
+    std::cout << "  steady gameplay ticks: " << steadyTicks << ", allocating: " << allocatingTicks;
+    if (allocatingTicks) std::cout << " (first at tick " << firstAllocatingTick << ", " << firstAllocations << " allocations)";
+    std::cout << std::endl;
+    if (checkAllocations && allocatingTicks > 0) {
+        std::cerr << "Steady-state ticks allocated on the heap" << std::endl;
+        return 4;
+    }
+    std::string outcome = lastOutcome == Outcome::NONE ? "In progress" : outcomeReason(lastOutcome);
+    std::cout << "Outcome: " << outcome << std::endl;
+    if (!expectedOutcome.empty() && outcome != expectedOutcome) {
+        std::cerr << "Expected outcome: " << expectedOutcome << std::endl;
+        return 3;
+    }
+    return 0;
+}
 
-void setupDungeon(Dungeon& dungeon) {
-    auto* entrance = new Room("Dungeon Entrance", "The heavy stone door slams shut behind you. Your only way is forward.", "dungeon.png");
-    auto* wizardStudy = new Room("Sanctum of Fire and Frost", "You dare enter my domain, mortal? The fire and frost bend to my will. If you wish to pass, you must defeat me first.", "wizard.png");
-    auto* dragonLair = new Room("Dragon's Lair", "The air is hot and smells of sulfur. A scaly beast awakens from its slumber.", "dragon.png");
-    auto* zombieCrypt = new Room("Zombie's Crypt", "Dust swirls through shafts of cold light. From the gloom, a corpse lurches forward with dead, hungry eyes.", "zombie.png");
-    auto* weaponRoom = new Room("Chamber of the Cursed Blades", "Dark swords float mid-air, glowing with runes. A red sigil burns behind them, pulsing with power.", "sword.png");
-    auto* choiceRoom = new Room("Room of Choice", "The hooded figure looks up from his book. 'You can only take one,' he says. 'The golden key... or the potion that gives you health'", "potion.png");
-    auto* monsterDen = new Room("Giant Monster's Den", "Huge claw marks scar the walls. A hulking creature guards the path ahead.", "monster.png");
-    auto* bossChamber = new Room("Final Boss Chamber", "This is it. The final guardian.", "finalboss.png");
-    auto* finalDoor = new Room("The Final Door", "You see a massive, ornate door with a single large keyhole. This must be the exit.", "finaldoor.png");
-
-    wizardStudy->entity = std::make_unique<MinionEnemy>("Wizard", 10);
-    dragonLair->entity = std::make_unique<MinionEnemy>("Dragon", 15);
-    zombieCrypt->entity = std::make_unique<MinionEnemy>("Zombie", 5);
-    weaponRoom->entity = std::make_unique<Weapon>("Sword");
-    choiceRoom->isChoiceRoom = true;
-    monsterDen->entity = std::make_unique<MinionEnemy>("Giant Monster", 10);
-    bossChamber->entity = std::make_unique<BossEnemy>("Final Boss", 75);
-    finalDoor->isFinalDoor = true;
-
-    dungeon.addRoom(entrance);
-    dungeon.addRoom(wizardStudy);
-    dungeon.addRoom(dragonLair);
-    dungeon.addRoom(zombieCrypt);
-    dungeon.addRoom(weaponRoom);
-    dungeon.addRoom(choiceRoom);
-    dungeon.addRoom(monsterDen);
-    dungeon.addRoom(bossChamber);
-    dungeon.addRoom(finalDoor);
+void Game::setPacing(PacingMode mode) {
+    pacing = mode;
+    window.setVerticalSyncEnabled(mode == PacingMode::VSYNC);
+    window.setFramerateLimit(mode == PacingMode::LIMITED ? GameConfig::FRAMERATE_LIMIT : 0);
+    nextFrameDeadline = pacingClock.getElapsedTime();
 }
 
-Game::Game()
-    : window(sf::VideoMode(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT), "Dungeon Escape"),
-      mainView(sf::FloatRect(0, 0, GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT))
-{
-    window.setFramerateLimit(GameConfig::FRAMERATE_LIMIT);
-
-    ResourceManager::getFont(GameConfig::FONT_PATH_ARIBLK);
-    ResourceManager::getTexture("dungeon.png");
-    ResourceManager::getTexture("wizard.png");
-    ResourceManager::getTexture("dragon.png");
-    ResourceManager::getTexture("zombie.png");
-    ResourceManager::getTexture("sword.png");
-    ResourceManager::getTexture("potion.png");
-    ResourceManager::getTexture("monster.png");
-    ResourceManager::getTexture("finalboss.png");
-    ResourceManager::getTexture("finaldoor.png");
-    ResourceManager::getBackgroundFrames("menu_bg", GameConfig::MENU_BG_PATH_PREFIX, GameConfig::MENU_BG_FRAME_COUNT);
-
-    screens[GameStateID::MENU] = std::make_unique<MenuScreen>();
-    screens[GameStateID::NAME_INPUT] = std::make_unique<NameInputScreen>(playerName);
-
-    currentStateID = GameStateID::MENU;
-    screens[currentStateID]->onEnter(*this);
-    handleResize(window.getSize().x, window.getSize().y);
+const char* Game::pacingName(PacingMode mode) {
+    switch (mode) {
+        case PacingMode::LIMITED: return "limited";
+        case PacingMode::VSYNC: return "vsync";
+        case PacingMode::PRECISE: return "precise";
+        case PacingMode::UNCAPPED: return "uncapped";
+    }
+    return "limited";
 }
 
-void Game::startGameplay() {
-    playerLogic = std::make_unique<Player>(playerName, 100, 10);
-    dungeonLogic = std::make_unique<Dungeon>(*playerLogic);
-    setupDungeon(*dungeonLogic);
-    screens[GameStateID::GAMEPLAY] = std::make_unique<GamePlayScreen>(*this);
-    changeScreen(GameStateID::GAMEPLAY);
+// PRECISE pacing: sf::sleep is only accurate to a millisecond or two, so it
+// sleeps until just short of the deadline and yields the rest. Deadlines
+// advance by whole periods so the average rate stays exact; after a long
+// stall they restart from now instead of rushing to catch up.
+void Game::paceFrame() {
+    if (pacing != PacingMode::PRECISE) return;
+    PROFILE_SCOPE("pacing");
+    const sf::Time period = sf::seconds(1.f / GameConfig::FRAMERATE_LIMIT);
+    nextFrameDeadline += period;
+    sf::Time now = pacingClock.getElapsedTime();
+    if (now > nextFrameDeadline + period) {
+        nextFrameDeadline = now;
+        return;
+    }
+    sf::Time spin = sf::seconds(GameConfig::PRECISE_PACING_SPIN);
+    if (nextFrameDeadline - now > spin) sf::sleep(nextFrameDeadline - now - spin);
+    while (pacingClock.getElapsedTime() < nextFrameDeadline) std::this_thread::yield();
 }
 
-void Game::run() {
-    while (window.isOpen()) {
-        sf::Time dt = gameClock.restart();
-        if (dt.asSeconds() > (1.f/20.f)) dt = sf::seconds(1.f/60.f);
-        processEvents();
-        update(dt);
-        render();
+// Profiler phase names for each screen, so the overlay breaks update and
+// draw time down by screen.
+const char* Game::screenPhase(GameStateID id, bool draw) {
+    switch (id) {
+        case GameStateID::LOADING: return draw ? "draw.loading" : "update.loading";
+        case GameStateID::MENU: return draw ? "draw.menu" : "update.menu";
+        case GameStateID::NAME_INPUT: return draw ? "draw.name_input" : "update.name_input";
+        case GameStateID::GAMEPLAY: return draw ? "draw.gameplay" : "update.gameplay";
+        case GameStateID::GAME_OVER: return draw ? "draw.game_over" : "update.game_over";
+        case GameStateID::NONE:
+        case GameStateID::COUNT: break;
+    }
+    return draw ? "draw.none" : "update.none";
+}
+
+// F3 toggles the overlay; F4 starts a capture, and pressing it again writes
+// it. F5 cycles the pacing mode, e.g. to uncap rendering while profiling.
+void Game::handleProfilerKeys(const sf::Event& event) {
+    if (event.type != sf::Event::KeyPressed) return;
+    if (event.key.code == sf::Keyboard::F3) profilerOverlay.toggle();
+    else if (event.key.code == sf::Keyboard::F5) setPacing(static_cast<PacingMode>((static_cast<int>(pacing) + 1) % 4));
+    else if (event.key.code == sf::Keyboard::F4) {
+        if (!Profiler::isCapturing()) {
+            Profiler::startCapture(GameConfig::PROFILE_CAPTURE_NAME);
+            return;
+        }
+        size_t frames = Profiler::capturedFrameCount();
+        if (Profiler::stopCapture()) std::cout << "Wrote " << frames << " frames to " << Profiler::captureName() << ".csv/.json" << std::endl;
+        else std::cerr << "Could not write profile capture: " << Profiler::captureName() << std::endl;
+        Profiler::setEnabled(profilerOverlay.isVisible());
     }
 }
 
@@ -1371,86 +2998,124 @@ void Game::processEvents() {
     sf::Event event;
     while (window.pollEvent(event)) {
         if (event.type == sf::Event::Closed) window.close();
-        if (event.type == sf::Event::Resized) handleResize(event.size.width, event.size.height);
-
-        if (currentTransition == TransitionState::NONE && screens.count(currentStateID)) {
-            screens.at(currentStateID)->handleEvent(event, *this);
-        }
+        if (event.type == sf::Event::LostFocus) focused = false;
+        if (event.type == sf::Event::GainedFocus) focused = true;
+        if (event.type != sf::Event::MouseMoved) redrawRequested = true;
+        handleProfilerKeys(event);
+        if (inputMode == InputMode::REPLAY) continue; // Only recorded input drives a replay.
+        if (inputMode == InputMode::RECORDING && inputClockStarted && InputLog::records(event)) inputLog.entries.push_back({inputTick, event});
+        dispatchEvent(event);
+    }
+    if (inputMode != InputMode::REPLAY) return;
+    while (replayCursor < inputLog.entries.size() && inputLog.entries[replayCursor].tick <= inputTick) {
+        dispatchEvent(inputLog.entries[replayCursor++].event);
     }
 }
 
+void Game::dispatchEvent(sf::Event& event) {
+    if (event.type == sf::Event::Resized) handleResize(event.size.width, event.size.height);
+    Screen* screen = screens.get(currentStateID);
+    if (!screenFade.isActive() && screen) screen->handleEvent(event, *this);
+}
+
 void Game::update(sf::Time dt) {
-    if (currentTransition == TransitionState::NONE) {
-        if (screens.count(currentStateID)) screens.at(currentStateID)->update(dt, *this);
+    {
+        PROFILE_SCOPE("update.tweens");
+        tweens.update(SimClock::getTime());
+    }
+    {
+        PROFILE_SCOPE("update.loader");
+        assetLoader.pump(GameConfig::TEXTURE_UPLOADS_PER_FRAME);
+    }
+    if (currentStateID == GameStateID::LOADING && ResourceManager::hasAtlas("menu_bg")) {
+        if (!screens.has(GameStateID::MENU)) {
+            inputClockStarted = true; // Tick 0 of recordings and replays.
+            // Built up front, behind the loading screen, so no later
+            // transition constructs a screen.
+            screens.add(GameStateID::MENU, std::make_unique<MenuScreen>());
+            screens.add(GameStateID::NAME_INPUT, std::make_unique<NameInputScreen>(playerName));
+            screens.add(GameStateID::GAMEPLAY, std::make_unique<GamePlayScreen>(*this));
+            screens.add(GameStateID::GAME_OVER, std::make_unique<GameOverScreen>());
+        }
+        changeScreen(GameStateID::MENU);
+    }
+
+    if (!screenFade.isActive()) {
+        PROFILE_SCOPE(screenPhase(currentStateID, false));
+        if (Screen* screen = screens.get(currentStateID)) screen->update(dt, *this);
     }
-    handleScreenTransition(dt);
     updateScreenShake();
 }
 
 void Game::render() {
-    window.clear(sf::Color::Black);
-    window.setView(mainView);
-    if (screens.count(currentStateID)) screens.at(currentStateID)->draw(window);
+    {
+        PROFILE_SCOPE("render");
+        window.clear(sf::Color::Black);
+        Screen* screen = screens.get(currentStateID);
+        PostEffects effects;
+        effects.shake = shakeOffset;
+        if (screenFade.isActive()) effects.addFade(screenFade.alpha() / 255.f);
+        if (screen) screen->addEffects(effects);
+        {
+            PROFILE_SCOPE(screenPhase(currentStateID, true));
+            sf::RenderTarget& target = postProcess.begin(window, mainView, effects);
+            if (screen) screen->draw(target);
+        }
+        {
+            PROFILE_SCOPE("render.post");
+            postProcess.end(window);
+        }
 
-    window.setView(window.getDefaultView());
-    if (currentTransition != TransitionState::NONE) window.draw(transitionRect);
+        window.setView(window.getDefaultView());
+        profilerOverlay.update(pacingName(pacing));
+        profilerOverlay.draw(window);
+    }
+    PROFILE_SCOPE("display");
     window.display();
 }
 
+// The magnitude eases out to zero over the duration.
 void Game::triggerScreenShake(float duration, float magnitude) {
-    if(isShaking) return;
-    isShaking = true;
-    shakeDuration = duration;
-    shakeMagnitude = magnitude;
-    shakeClock.restart();
+    if (tweens.isActive(shakeTween)) return;
+    shakeTween = tweens.start({magnitude, 0.f, duration, Ease::OUT_QUAD, false, &shakeMagnitude});
 }
 
 void Game::updateScreenShake() {
-    if (!isShaking) {
-        mainView.setCenter(GameConfig::WINDOW_WIDTH / 2.f, GameConfig::WINDOW_HEIGHT / 2.f);
-        return;
-    }
-
-    if (shakeClock.getElapsedTime().asSeconds() > shakeDuration) {
-        isShaking = false;
-        mainView.setCenter(GameConfig::WINDOW_WIDTH / 2.f, GameConfig::WINDOW_HEIGHT / 2.f);
+    if (!tweens.isActive(shakeTween)) {
+        shakeOffset = sf::Vector2f();
     } else {
         std::uniform_real_distribution<float> dist(-shakeMagnitude, shakeMagnitude);
         float x = dist(rng);
         float y = dist(rng);
-        mainView.setCenter(GameConfig::WINDOW_WIDTH / 2.f + x, GameConfig::WINDOW_HEIGHT / 2.f + y);
+        shakeOffset = sf::Vector2f(x, y);
     }
 }
 
 void Game::changeScreen(GameStateID newStateID) {
-    if (currentTransition == TransitionState::NONE && newStateID != currentStateID) {
+    if (!screenFade.isActive() && newStateID != currentStateID) {
         nextStateID = newStateID;
-        currentTransition = TransitionState::FADING_OUT;
-        transitionClock.restart();
+        screenFade.fadeOut([](void* game, int) { static_cast<Game*>(game)->enterNextScreen(); }, this);
+        audio.playMusic(screenMusic(newStateID), GameConfig::MUSIC_CROSSFADE);
     }
 }
 
-void Game::handleScreenTransition(sf::Time dt) {
-    if (currentTransition == TransitionState::NONE) return;
-    float t = Utils::clamp(transitionClock.getElapsedTime().asSeconds() / GameConfig::TRANSITION_DURATION, 0.f, 1.f);
-    sf::Uint8 alpha;
-
-    if (currentTransition == TransitionState::FADING_OUT) {
-        alpha = static_cast<sf::Uint8>(Utils::lerp(0.f, 255.f, t));
-        if (t >= 1.0f) {
-            currentStateID = nextStateID;
-            if (screens.count(currentStateID)) {
-                screens.at(currentStateID)->onEnter(*this);
-                screens.at(currentStateID)->onResize(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
-            }
-            currentTransition = TransitionState::FADING_IN;
-            transitionClock.restart();
-        }
-    } else { // FADING_IN
-        alpha = static_cast<sf::Uint8>(Utils::lerp(255.f, 0.f, t));
-        if (t >= 1.0f) currentTransition = TransitionState::NONE;
+// Track for each screen. There is a single track today, so changing
+// screens keeps it playing; a new entry here crossfades on the change.
+MusicId Game::screenMusic(GameStateID id) {
+    switch (id) {
+        default: return MusicId::DUNGEON;
+    }
+}
+
+// Runs at full black, from the fade-out's completion.
+void Game::enterNextScreen() {
+    if (Screen* screen = screens.get(currentStateID)) screen->onExit(*this);
+    currentStateID = nextStateID;
+    if (Screen* screen = screens.get(currentStateID)) {
+        screen->onEnter(*this);
+        screen->onResize(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
     }
-    transitionRect.setFillColor(sf::Color(0, 0, 0, alpha));
+    screenFade.fadeIn();
 }
 
 void Game::handleResize(unsigned int actualWidth, unsigned int actualHeight) {
@@ -1471,27 +3136,55 @@ void Game::handleResize(unsigned int actualWidth, unsigned int actualHeight) {
 
     mainView.setViewport(viewport);
     mainView.setSize(virtualWidth, virtualHeight);
+    BackgroundCache::setPixelScale(viewport.width * actualWidth / virtualWidth);
     mainView.setCenter(virtualWidth / 2.f, virtualHeight / 2.f);
 
-    transitionRect.setSize({(float)actualWidth, (float)actualHeight});
-
-    if (screens.count(currentStateID)) {
-        screens.at(currentStateID)->onResize(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
+    if (Screen* screen = screens.get(currentStateID)) {
+        screen->onResize(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
     }
 }
 
-
-int main() {
-    try {
-        sf::Music backgroundMusic;
-    if (!backgroundMusic.openFromFile("assets/dungeon_music.ogg")) {
-        return -1;
+// bench.cpp compiles this file with DUNGEON_NO_MAIN to reach the classes above.
+#ifndef DUNGEON_NO_MAIN
+int main(int argc, char* argv[]) {
+    // --pacing limited|vsync|precise|uncapped
+    // --record FILE                 writes the session's input to FILE on exit
+    // --replay FILE [--no-render] [--expect OUTCOME] [--check-allocs]
+    // --always-render                draws every frame, even when idle or unfocused
+    // --no-shaders                   draws fades, flash and shake without the post-process shader
+    PacingMode pacing = PacingMode::LIMITED;
+    std::string recordPath, replayPath, expectedOutcome;
+    bool replayDraws = true, powerSaving = true, checkAllocations = false, postShader = GameConfig::POST_PROCESS_SHADER;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--no-render") replayDraws = false;
+        if (arg == "--always-render") powerSaving = false;
+        if (arg == "--check-allocs") checkAllocations = true;
+        if (arg == "--no-shaders") postShader = false;
+        if (i + 1 == argc) continue;
+        if (arg == "--record") recordPath = argv[++i];
+        else if (arg == "--replay") replayPath = argv[++i];
+        else if (arg == "--expect") expectedOutcome = argv[++i];
+        else if (arg == "--pacing") {
+            std::string mode = argv[++i];
+            for (PacingMode candidate : {PacingMode::LIMITED, PacingMode::VSYNC, PacingMode::PRECISE, PacingMode::UNCAPPED}) {
+                if (mode == Game::pacingName(candidate)) pacing = candidate;
+            }
+        }
     }
 
-    backgroundMusic.setLoop(true);
-    backgroundMusic.setVolume(50);
-    backgroundMusic.play();
-        Game game;
+    try {
+        // Optional: without a pack every asset is read as a loose file.
+        AssetPack::open(GameConfig::ASSET_PACK_PATH);
+
+        Game game(pacing);
+        if (!postShader) game.setPostShader(false);
+        if (!replayPath.empty()) {
+            if (!game.loadReplay(replayPath)) return 1;
+            return game.runReplay(replayDraws, expectedOutcome, checkAllocations);
+        }
+        if (!recordPath.empty()) game.recordInput(recordPath);
+        game.setPowerSaving(powerSaving);
         game.run();
     } catch (const std::exception& e) {
         std::cerr << "Critical Error: " << e.what() << std::endl;
@@ -1501,4 +3194,5 @@ int main() {
         return 1;
     }
     return 0;
-}
\ No newline at end of file
+}
+#endif // DUNGEON_NO_MAIN
@@ -0,0 +1,104 @@
+#include "asset_pack.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// =================================================================
+// ASSET PACKER
+// Builds the asset pack read by AssetPack (see asset_pack.hpp).
+//   packer <output.pak> <file>...
+// Each file is stored under the path exactly as given, so run it from the
+// game's working directory: packer assets.pak assets/*.png assets/*.ttf assets/*.ogg
+// =================================================================
+
+namespace {
+    struct InputFile {
+        std::string path;
+        std::vector<char> bytes;
+    };
+
+    bool readFile(const std::string& path, std::vector<char>& bytes) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) return false;
+        std::streamoff size = in.tellg();
+        in.seekg(0);
+        bytes.resize(static_cast<size_t>(size));
+        return size == 0 || static_cast<bool>(in.read(bytes.data(), size));
+    }
+
+    void writePadding(std::ofstream& out, std::uint64_t from, std::uint64_t to) {
+        static const char zeros[PackFormat::PACK_ALIGNMENT] = {};
+        if (to > from) out.write(zeros, static_cast<std::streamsize>(to - from));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    using namespace PackFormat;
+    if (argc < 3) {
+        std::cerr << "Usage: packer <output.pak> <file>..." << std::endl;
+        return 1;
+    }
+
+    std::vector<InputFile> inputs;
+    for (int i = 2; i < argc; ++i) {
+        std::string path = argv[i];
+        std::replace(path.begin(), path.end(), '\\', '/');
+        if (path.size() > MAX_NAME_LENGTH) {
+            std::cerr << "Path too long for the pack index: " << path << std::endl;
+            return 1;
+        }
+        InputFile input;
+        input.path = path;
+        if (!readFile(argv[i], input.bytes)) {
+            std::cerr << "Could not read: " << argv[i] << std::endl;
+            return 1;
+        }
+        inputs.push_back(std::move(input));
+    }
+    // The index is binary-searched at runtime, so it must be sorted by name.
+    std::sort(inputs.begin(), inputs.end(), [](const InputFile& a, const InputFile& b) { return a.path < b.path; });
+    for (size_t i = 1; i < inputs.size(); ++i) {
+        if (inputs[i].path == inputs[i - 1].path) {
+            std::cerr << "Duplicate entry: " << inputs[i].path << std::endl;
+            return 1;
+        }
+    }
+
+    PackHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entryCount = static_cast<std::uint32_t>(inputs.size());
+
+    std::vector<PackEntry> entries(inputs.size());
+    std::uint64_t offset = alignUp(sizeof(PackHeader) + entries.size() * sizeof(PackEntry));
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        std::memset(&entries[i], 0, sizeof(PackEntry));
+        std::memcpy(entries[i].name, inputs[i].path.c_str(), inputs[i].path.size());
+        entries[i].offset = offset;
+        entries[i].size = inputs[i].bytes.size();
+        offset = alignUp(offset + inputs[i].bytes.size());
+    }
+
+    std::ofstream out(argv[1], std::ios::binary);
+    if (!out) {
+        std::cerr << "Could not create: " << argv[1] << std::endl;
+        return 1;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+    std::uint64_t written = sizeof(PackHeader) + entries.size() * sizeof(PackEntry);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        writePadding(out, written, entries[i].offset);
+        out.write(inputs[i].bytes.data(), static_cast<std::streamsize>(inputs[i].bytes.size()));
+        written = entries[i].offset + inputs[i].bytes.size();
+    }
+    if (!out) {
+        std::cerr << "Write failed: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Packed " << inputs.size() << " files (" << written << " bytes) into " << argv[1] << std::endl;
+    return 0;
+}
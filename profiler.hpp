@@ -0,0 +1,277 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+// =================================================================
+// FRAME PROFILER
+// Scoped wall-clock timers for the frame loop, with no SFML dependency.
+//   PROFILE_SCOPE("update");
+// While the profiler is disabled (the default) a scope costs one branch;
+// building with -DDUNGEON_NO_PROFILER removes the scopes entirely.
+//
+// Enabled, the per-phase time of the last HISTORY_FRAMES frames is kept for
+// the on-screen overlay. A capture also records every scope and, when
+// stopped, writes <name>.csv (one row per frame, milliseconds per phase)
+// and <name>.json (Chrome trace events, for chrome://tracing or Perfetto).
+// Phase times are inclusive: "render" contains the screen's own draw scope.
+//
+// Heap allocations are counted the same way, per frame and per phase, when
+// the program replaces operator new to feed allocationCounters() (the game
+// does, see main.cpp); otherwise the counts stay zero. Counters are per
+// thread and the profiler reads the main thread's, so loader and audio
+// threads do not show up in frame counts.
+// =================================================================
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <algorithm>
+
+struct AllocationCounters {
+    std::uint64_t count;
+    std::uint64_t bytes;
+};
+
+// The calling thread's running totals.
+inline AllocationCounters& allocationCounters() {
+    static thread_local AllocationCounters counters = {0, 0};
+    return counters;
+}
+
+class Profiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+    static const int MAX_PHASES = 32;
+    static const int HISTORY_FRAMES = 240;
+
+    struct FrameRecord {
+        float totalMs;
+        float phaseMs[MAX_PHASES];
+        std::uint32_t allocations;
+        std::uint32_t allocatedBytes;
+        std::uint32_t phaseAllocations[MAX_PHASES];
+    };
+
+private:
+    struct TraceEvent {
+        int phase; // -1 for the whole frame.
+        std::int64_t startUs;
+        std::int64_t durationUs;
+        std::uint32_t allocations;
+    };
+
+    struct State {
+        bool enabled = false;
+        bool capturing = false;
+        bool inFrame = false;
+        std::string captureName;
+        const char* phaseNames[MAX_PHASES] = {};
+        int phaseCount = 0;
+        Clock::time_point origin = Clock::now();
+        Clock::time_point frameStart;
+        AllocationCounters frameAllocationStart = {0, 0};
+        FrameRecord current = {};
+        FrameRecord history[HISTORY_FRAMES] = {};
+        int historyCount = 0;
+        int historyNext = 0;
+        std::vector<FrameRecord> capturedFrames;
+        std::vector<TraceEvent> capturedEvents;
+    };
+
+    static State& state() { static State s; return s; }
+
+    static std::int64_t micros(Clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(t - state().origin).count();
+    }
+
+    static void writeCsv(const State& s, std::ofstream& out) {
+        out << "frame,total_ms,allocations,allocated_bytes";
+        for (int i = 0; i < s.phaseCount; ++i) out << ',' << s.phaseNames[i] << "_ms";
+        for (int i = 0; i < s.phaseCount; ++i) out << ',' << s.phaseNames[i] << "_allocs";
+        out << '\n';
+        for (size_t f = 0; f < s.capturedFrames.size(); ++f) {
+            const FrameRecord& frame = s.capturedFrames[f];
+            out << f << ',' << frame.totalMs << ',' << frame.allocations << ',' << frame.allocatedBytes;
+            for (int i = 0; i < s.phaseCount; ++i) out << ',' << frame.phaseMs[i];
+            for (int i = 0; i < s.phaseCount; ++i) out << ',' << frame.phaseAllocations[i];
+            out << '\n';
+        }
+    }
+
+    static void writeTrace(const State& s, std::ofstream& out) {
+        out << "{\"traceEvents\":[\n";
+        for (size_t i = 0; i < s.capturedEvents.size(); ++i) {
+            const TraceEvent& e = s.capturedEvents[i];
+            out << (i == 0 ? "" : ",\n") << "{\"name\":\"" << (e.phase < 0 ? "frame" : s.phaseNames[e.phase])
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << e.startUs << ",\"dur\":" << e.durationUs
+                << ",\"args\":{\"allocations\":" << e.allocations << "}}";
+        }
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+public:
+    static bool isEnabled() { return state().enabled; }
+    static bool isCapturing() { return state().capturing; }
+
+    static void setEnabled(bool enabled) {
+        State& s = state();
+        if (!enabled && s.capturing) stopCapture();
+        s.enabled = enabled;
+        s.inFrame = false;
+    }
+
+    // Index of a phase, registered on first use. Names must outlive the
+    // profiler (string literals). Returns -1 once MAX_PHASES are in use.
+    static int phase(const char* name) {
+        State& s = state();
+        for (int i = 0; i < s.phaseCount; ++i) {
+            if (s.phaseNames[i] == name || std::strcmp(s.phaseNames[i], name) == 0) return i;
+        }
+        if (s.phaseCount == MAX_PHASES) return -1;
+        s.phaseNames[s.phaseCount] = name;
+        return s.phaseCount++;
+    }
+
+    static void beginFrame() {
+        State& s = state();
+        if (!s.enabled) return;
+        s.frameStart = Clock::now();
+        s.frameAllocationStart = allocationCounters();
+        s.current = FrameRecord();
+        s.inFrame = true;
+    }
+
+    static void endFrame() {
+        State& s = state();
+        if (!s.inFrame) return;
+        Clock::time_point end = Clock::now();
+        s.current.totalMs = std::chrono::duration<float, std::milli>(end - s.frameStart).count();
+        const AllocationCounters& now = allocationCounters();
+        s.current.allocations = static_cast<std::uint32_t>(now.count - s.frameAllocationStart.count);
+        s.current.allocatedBytes = static_cast<std::uint32_t>(now.bytes - s.frameAllocationStart.bytes);
+        s.history[s.historyNext] = s.current;
+        s.historyNext = (s.historyNext + 1) % HISTORY_FRAMES;
+        if (s.historyCount < HISTORY_FRAMES) s.historyCount++;
+        if (s.capturing) {
+            s.capturedFrames.push_back(s.current);
+            s.capturedEvents.push_back({-1, micros(s.frameStart), micros(end) - micros(s.frameStart), s.current.allocations});
+        }
+        s.inFrame = false;
+    }
+
+    static void record(int index, Clock::time_point start, Clock::time_point end, std::uint32_t allocations) {
+        State& s = state();
+        if (!s.inFrame) return;
+        s.current.phaseMs[index] += std::chrono::duration<float, std::milli>(end - start).count();
+        s.current.phaseAllocations[index] += allocations;
+        if (s.capturing) s.capturedEvents.push_back({index, micros(start), micros(end) - micros(start), allocations});
+    }
+
+    static void startCapture(const std::string& name) {
+        State& s = state();
+        s.enabled = true;
+        s.capturing = true;
+        s.captureName = name;
+        s.capturedFrames.clear();
+        s.capturedEvents.clear();
+        s.capturedFrames.reserve(60 * 60);
+        s.capturedEvents.reserve(60 * 60 * 16);
+    }
+
+    // Writes the capture; false if either file could not be written.
+    static bool stopCapture() {
+        State& s = state();
+        if (!s.capturing) return false;
+        s.capturing = false;
+        std::ofstream csv(s.captureName + ".csv");
+        std::ofstream trace(s.captureName + ".json");
+        if (csv) writeCsv(s, csv);
+        if (trace) writeTrace(s, trace);
+        return csv.good() && trace.good();
+    }
+    static const std::string& captureName() { return state().captureName; }
+    static size_t capturedFrameCount() { return state().capturedFrames.size(); }
+
+    // --- Overlay statistics over the recent history ---
+    static int historySize() { return state().historyCount; }
+    static int phaseCount() { return state().phaseCount; }
+    static const char* phaseName(int index) { return state().phaseNames[index]; }
+
+    static float frameTimePercentile(float p) {
+        const State& s = state();
+        if (s.historyCount == 0) return 0.f;
+        float totals[HISTORY_FRAMES];
+        for (int i = 0; i < s.historyCount; ++i) totals[i] = s.history[i].totalMs;
+        int k = std::min(s.historyCount - 1, static_cast<int>(p * s.historyCount));
+        std::nth_element(totals, totals + k, totals + s.historyCount);
+        return totals[k];
+    }
+
+    static float averageFrameMs() {
+        const State& s = state();
+        float sum = 0.f;
+        for (int i = 0; i < s.historyCount; ++i) sum += s.history[i].totalMs;
+        return s.historyCount ? sum / s.historyCount : 0.f;
+    }
+
+    static float averagePhaseMs(int index) {
+        const State& s = state();
+        float sum = 0.f;
+        for (int i = 0; i < s.historyCount; ++i) sum += s.history[i].phaseMs[index];
+        return s.historyCount ? sum / s.historyCount : 0.f;
+    }
+
+    static float averageAllocations() {
+        const State& s = state();
+        float sum = 0.f;
+        for (int i = 0; i < s.historyCount; ++i) sum += s.history[i].allocations;
+        return s.historyCount ? sum / s.historyCount : 0.f;
+    }
+
+    static float averageAllocatedBytes() {
+        const State& s = state();
+        float sum = 0.f;
+        for (int i = 0; i < s.historyCount; ++i) sum += s.history[i].allocatedBytes;
+        return s.historyCount ? sum / s.historyCount : 0.f;
+    }
+
+    static float averagePhaseAllocations(int index) {
+        const State& s = state();
+        float sum = 0.f;
+        for (int i = 0; i < s.historyCount; ++i) sum += s.history[i].phaseAllocations[index];
+        return s.historyCount ? sum / s.historyCount : 0.f;
+    }
+};
+
+class ProfileScope {
+private:
+    int index = -1;
+    Profiler::Clock::time_point start;
+    std::uint64_t allocationStart = 0;
+public:
+    explicit ProfileScope(const char* name) {
+        if (!Profiler::isEnabled()) return;
+        index = Profiler::phase(name);
+        allocationStart = allocationCounters().count;
+        start = Profiler::Clock::now();
+    }
+    ~ProfileScope() {
+        if (index < 0) return;
+        Profiler::Clock::time_point end = Profiler::Clock::now();
+        Profiler::record(index, start, end, static_cast<std::uint32_t>(allocationCounters().count - allocationStart));
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#ifdef DUNGEON_NO_PROFILER
+#define PROFILE_SCOPE(name) ((void)0)
+#else
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#endif
+
+#endif // PROFILER_HPP